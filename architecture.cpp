@@ -23,6 +23,8 @@
 #include <cstdint>
 #include <inttypes.h>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include "binaryninjaapi.h"
 
 using namespace BinaryNinja;
@@ -165,6 +167,171 @@ vector<InstructionTextToken> InstructionTextToken::ConvertInstructionTextTokenLi
 }
 
 
+const char* InstructionTextTokenBuilder::Intern(const string& text)
+{
+	// Never freed, interned strings are referenced by token lists for the lifetime of the process
+	static mutex* internMutex = new mutex;
+	static unordered_set<string>* interned = new unordered_set<string>;
+	lock_guard<mutex> lock(*internMutex);
+	return interned->insert(text).first->c_str();
+}
+
+
+size_t InstructionTextTokenBuilder::StoreString(const char* text, size_t len)
+{
+	size_t offset = m_strings.size();
+	m_strings.insert(m_strings.end(), text, text + len);
+	m_strings.push_back(0);
+	return offset;
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::AddToken(BNInstructionTextTokenType type,
+    const TokenText& text, uint64_t value, size_t size, size_t operand, uint8_t confidence, uint64_t width)
+{
+	BNInstructionTextToken token;
+	token.type = type;
+	token.text = nullptr;
+	token.value = value;
+	token.width = (width == InstructionTextToken::WidthIsByteCount) ? text.length : width;
+	token.size = size;
+	token.operand = operand;
+	token.context = NoTokenContext;
+	token.confidence = confidence;
+	token.address = 0;
+	token.typeNames = nullptr;
+	token.namesCount = 0;
+	m_tokens.push_back(token);
+	m_text.push_back(text);
+	return *this;
+}
+
+
+void InstructionTextTokenBuilder::Clear()
+{
+	m_tokens.clear();
+	m_text.clear();
+	m_names.clear();
+	m_strings.clear();
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::Add(BNInstructionTextTokenType type, const string& text,
+    uint64_t value, size_t size, size_t operand, uint8_t confidence, uint64_t width)
+{
+	TokenText tokenText {nullptr, StoreString(text.c_str(), text.size()), text.size(), m_names.size(), 0};
+	return AddToken(type, tokenText, value, size, operand, confidence, width);
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::AddInterned(BNInstructionTextTokenType type,
+    const char* text, uint64_t value, size_t size, size_t operand, uint8_t confidence, uint64_t width)
+{
+	TokenText tokenText {text, 0, strlen(text), m_names.size(), 0};
+	return AddToken(type, tokenText, value, size, operand, confidence, width);
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::Add(const InstructionTextToken& token)
+{
+	Add(token.type, token.text, token.value, token.size, token.operand, token.confidence, token.width);
+	SetContext(token.context, token.address);
+	for (auto& name : token.typeNames)
+		AddTypeName(name);
+	return *this;
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::Add(const vector<InstructionTextToken>& tokens)
+{
+	for (auto& token : tokens)
+		Add(token);
+	return *this;
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::SetContext(
+    BNInstructionTextTokenContext context, uint64_t address)
+{
+	if (!m_tokens.empty())
+	{
+		m_tokens.back().context = context;
+		m_tokens.back().address = address;
+	}
+	return *this;
+}
+
+
+InstructionTextTokenBuilder& InstructionTextTokenBuilder::AddTypeName(const string& name)
+{
+	// Names of a token are contiguous, so they can only be added to the last token
+	if (!m_text.empty())
+	{
+		m_names.emplace_back(StoreString(name.c_str(), name.size()), name.size());
+		m_text.back().nameCount++;
+	}
+	return *this;
+}
+
+
+vector<InstructionTextToken> InstructionTextTokenBuilder::ToVector() const
+{
+	vector<InstructionTextToken> result;
+	result.reserve(m_tokens.size());
+	for (size_t i = 0; i < m_tokens.size(); i++)
+	{
+		const BNInstructionTextToken& token = m_tokens[i];
+		const TokenText& text = m_text[i];
+		vector<string> typeNames;
+		typeNames.reserve(text.nameCount);
+		for (size_t j = 0; j < text.nameCount; j++)
+		{
+			auto& name = m_names[text.firstName + j];
+			typeNames.emplace_back(&m_strings[name.first], name.second);
+		}
+		result.emplace_back(token.type, token.context,
+		    text.interned ? string(text.interned, text.length) : string(&m_strings[text.offset], text.length),
+		    token.address, token.value, token.size, token.operand, token.confidence, typeNames, token.width);
+	}
+	return result;
+}
+
+
+BNInstructionTextToken* InstructionTextTokenBuilder::CreateInstructionTextTokenList() const
+{
+	// Tokens, type name pointers and strings share one allocation, interned strings are not copied
+	size_t tokenBytes = m_tokens.size() * sizeof(BNInstructionTextToken);
+	size_t nameBytes = m_names.size() * sizeof(char*);
+	char* block = (char*)malloc(tokenBytes + nameBytes + m_strings.size() + 1);
+	if (!block)
+		throw std::bad_alloc();
+
+	BNInstructionTextToken* tokens = (BNInstructionTextToken*)block;
+	char** names = (char**)(block + tokenBytes);
+	char* strings = block + tokenBytes + nameBytes;
+	if (!m_strings.empty())
+		memcpy(strings, m_strings.data(), m_strings.size());
+
+	for (size_t i = 0; i < m_tokens.size(); i++)
+	{
+		const TokenText& text = m_text[i];
+		tokens[i] = m_tokens[i];
+		tokens[i].text = text.interned ? (char*)text.interned : strings + text.offset;
+		tokens[i].typeNames = names + text.firstName;
+		tokens[i].namesCount = text.nameCount;
+		for (size_t j = 0; j < text.nameCount; j++)
+			names[text.firstName + j] = strings + m_names[text.firstName + j].first;
+	}
+	return tokens;
+}
+
+
+void InstructionTextTokenBuilder::FreeInstructionTextTokenList(BNInstructionTextToken* tokens)
+{
+	free(tokens);
+}
+
+
 Architecture::Architecture(BNArchitecture* arch)
 {
 	m_object = arch;
@@ -177,6 +344,210 @@ Architecture::Architecture(const string& name) : m_nameForRegister(name)
 }
 
 
+// Architectures cannot be unregistered, so their metadata lives for the rest of the process
+struct Architecture::Metadata
+{
+	// Names indexed by id, only built when all ids are small enough for a flat array
+	struct NameTable
+	{
+		vector<uint32_t> ids;
+		vector<string> names;
+		vector<uint8_t> present;
+
+		const string* Find(uint32_t id) const { return (id < present.size() && present[id]) ? &names[id] : nullptr; }
+	};
+
+	enum RegisterFlags : uint8_t
+	{
+		RegisterPresent = 1,
+		GlobalRegister = 2,
+		SystemRegister = 4
+	};
+
+	static constexpr uint32_t MaxTableId = 0x10000;
+
+	bool valid = true;
+	NameTable registers;
+	vector<BNRegisterInfo> registerInfo;
+	vector<uint32_t> registerStackForRegister;
+	vector<uint8_t> registerFlags;
+	vector<uint32_t> registerNameSlots;  // Open addressed hash of register names, holding id + 1
+	vector<uint32_t> fullWidthRegisters, globalRegisters, systemRegisters;
+	uint32_t stackPointer, linkRegister;
+
+	NameTable flags, flagWriteTypes, semanticFlagClasses, semanticFlagGroups, intrinsics, registerStacks;
+	vector<BNRegisterStackInfo> registerStackInfo;
+
+	static uint64_t HashName(const char* name, size_t len)
+	{
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (size_t i = 0; i < len; i++)
+			hash = (hash ^ (uint8_t)name[i]) * 0x100000001b3ULL;
+		return hash;
+	}
+
+	static vector<uint32_t> GetList(BNArchitecture* arch, uint32_t* (*getList)(BNArchitecture*, size_t*))
+	{
+		size_t count;
+		uint32_t* list = getList(arch, &count);
+		vector<uint32_t> result(list, list + count);
+		BNFreeRegisterList(list);
+		return result;
+	}
+
+	bool BuildNameTable(NameTable& table, vector<uint32_t> ids, const function<char*(uint32_t)>& getName)
+	{
+		uint32_t maxId = 0;
+		for (auto id : ids)
+		{
+			if (id >= MaxTableId)
+				return false;
+			maxId = max(maxId, id + 1);
+		}
+		table.names.resize(maxId);
+		table.present.resize(maxId, 0);
+		for (auto id : ids)
+		{
+			char* name = getName(id);
+			table.names[id] = name;
+			table.present[id] = 1;
+			BNFreeString(name);
+		}
+		table.ids = std::move(ids);
+		return true;
+	}
+
+	Metadata(BNArchitecture* arch)
+	{
+		valid = BuildNameTable(registers, GetList(arch, BNGetAllArchitectureRegisters),
+		            [&](uint32_t id) { return BNGetArchitectureRegisterName(arch, id); })
+		    && BuildNameTable(flags, GetList(arch, BNGetAllArchitectureFlags),
+		        [&](uint32_t id) { return BNGetArchitectureFlagName(arch, id); })
+		    && BuildNameTable(flagWriteTypes, GetList(arch, BNGetAllArchitectureFlagWriteTypes),
+		        [&](uint32_t id) { return BNGetArchitectureFlagWriteTypeName(arch, id); })
+		    && BuildNameTable(semanticFlagClasses, GetList(arch, BNGetAllArchitectureSemanticFlagClasses),
+		        [&](uint32_t id) { return BNGetArchitectureSemanticFlagClassName(arch, id); })
+		    && BuildNameTable(semanticFlagGroups, GetList(arch, BNGetAllArchitectureSemanticFlagGroups),
+		        [&](uint32_t id) { return BNGetArchitectureSemanticFlagGroupName(arch, id); })
+		    && BuildNameTable(intrinsics, GetList(arch, BNGetAllArchitectureIntrinsics),
+		        [&](uint32_t id) { return BNGetArchitectureIntrinsicName(arch, id); })
+		    && BuildNameTable(registerStacks, GetList(arch, BNGetAllArchitectureRegisterStacks),
+		        [&](uint32_t id) { return BNGetArchitectureRegisterStackName(arch, id); });
+		if (!valid)
+			return;
+
+		size_t regCount = registers.names.size();
+		registerInfo.resize(regCount);
+		registerStackForRegister.resize(regCount, BN_INVALID_REGISTER);
+		registerFlags.resize(regCount, 0);
+		for (auto reg : registers.ids)
+		{
+			registerInfo[reg] = BNGetArchitectureRegisterInfo(arch, reg);
+			registerStackForRegister[reg] = BNGetArchitectureRegisterStackForRegister(arch, reg);
+			registerFlags[reg] = RegisterPresent;
+		}
+
+		fullWidthRegisters = GetList(arch, BNGetFullWidthArchitectureRegisters);
+		globalRegisters = GetList(arch, BNGetArchitectureGlobalRegisters);
+		systemRegisters = GetList(arch, BNGetArchitectureSystemRegisters);
+		for (auto reg : globalRegisters)
+			if (reg < regCount)
+				registerFlags[reg] |= GlobalRegister;
+		for (auto reg : systemRegisters)
+			if (reg < regCount)
+				registerFlags[reg] |= SystemRegister;
+		stackPointer = BNGetArchitectureStackPointerRegister(arch);
+		linkRegister = BNGetArchitectureLinkRegister(arch);
+
+		registerStackInfo.resize(registerStacks.names.size());
+		for (auto regStack : registerStacks.ids)
+			registerStackInfo[regStack] = BNGetArchitectureRegisterStackInfo(arch, regStack);
+
+		size_t slotCount = 16;
+		while (slotCount < registers.ids.size() * 2)
+			slotCount *= 2;
+		registerNameSlots.resize(slotCount, 0);
+		for (auto reg : registers.ids)
+		{
+			const string& name = registers.names[reg];
+			size_t slot = HashName(name.c_str(), name.size()) & (slotCount - 1);
+			while (registerNameSlots[slot])
+				slot = (slot + 1) & (slotCount - 1);
+			registerNameSlots[slot] = reg + 1;
+		}
+	}
+
+	bool FindRegisterByName(const string& name, uint32_t& result) const
+	{
+		size_t mask = registerNameSlots.size() - 1;
+		for (size_t slot = HashName(name.c_str(), name.size()) & mask; registerNameSlots[slot];
+		     slot = (slot + 1) & mask)
+		{
+			uint32_t reg = registerNameSlots[slot] - 1;
+			if (registers.names[reg] == name)
+			{
+				result = reg;
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+
+const Architecture::Metadata* Architecture::GetMetadata()
+{
+	const Metadata* metadata = m_metadata.load(memory_order_acquire);
+	if (metadata)
+		return metadata->valid ? metadata : nullptr;
+	if (!m_object)
+		return nullptr;
+
+	// Wrappers are created for the same architecture all the time, so the tables are shared by core object
+	static mutex* registryMutex = new mutex;
+	static unordered_map<BNArchitecture*, const Metadata*>* registry =
+	    new unordered_map<BNArchitecture*, const Metadata*>;
+	{
+		lock_guard<mutex> lock(*registryMutex);
+		auto i = registry->find(m_object);
+		if (i != registry->end())
+			metadata = i->second;
+	}
+
+	if (!metadata)
+	{
+		// The queries can call back into a plugin architecture, which may look up its own registers while its
+		// tables are being built. Those lookups go to the core instead of building the tables again.
+		static thread_local vector<BNArchitecture*> building;
+		if (find(building.begin(), building.end(), m_object) != building.end())
+			return nullptr;
+
+		// Built without holding the lock, as the queries can call back into other architectures
+		unique_ptr<Metadata> built;
+		building.push_back(m_object);
+		try
+		{
+			built.reset(new Metadata(m_object));
+		}
+		catch (...)
+		{
+			building.pop_back();
+			throw;
+		}
+		building.pop_back();
+
+		lock_guard<mutex> lock(*registryMutex);
+		auto i = registry->emplace(m_object, built.get());
+		if (i.second)
+			built.release();
+		metadata = i.first->second;
+	}
+
+	m_metadata.store(metadata, memory_order_release);
+	return metadata->valid ? metadata : nullptr;
+}
+
+
 void Architecture::InitCallback(void* ctxt, BNArchitecture* obj)
 {
 	CallbackRef<Architecture> arch(ctxt);
@@ -250,8 +621,28 @@ bool Architecture::GetInstructionTextCallback(
 {
 	CallbackRef<Architecture> arch(ctxt);
 
-	vector<InstructionTextToken> tokens;
-	bool ok = arch->GetInstructionText(data, addr, *len, tokens);
+	// Builders are reused per thread. Text callbacks can nest when an architecture requests text from another
+	// architecture, so each nesting level has its own builder.
+	static thread_local vector<unique_ptr<InstructionTextTokenBuilder>> builders;
+	static thread_local size_t depth = 0;
+	if (depth == builders.size())
+		builders.emplace_back(new InstructionTextTokenBuilder);
+	InstructionTextTokenBuilder& tokens = *builders[depth];
+	tokens.Clear();
+
+	depth++;
+	bool ok;
+	try
+	{
+		ok = arch->GetInstructionText(data, addr, *len, tokens);
+	}
+	catch (...)
+	{
+		depth--;
+		throw;
+	}
+	depth--;
+
 	if (!ok)
 	{
 		*result = nullptr;
@@ -259,30 +650,75 @@ bool Architecture::GetInstructionTextCallback(
 		return false;
 	}
 
-	*count = tokens.size();
-	*result = InstructionTextToken::CreateInstructionTextTokenList(tokens);
+	*count = tokens.GetCount();
+	*result = tokens.CreateInstructionTextTokenList();
 	return true;
 }
 
 
-void Architecture::FreeInstructionTextCallback(BNInstructionTextToken* tokens, size_t count)
+void Architecture::FreeInstructionTextCallback(BNInstructionTextToken* tokens, size_t)
 {
-	for (size_t i = 0; i < count; i++)
+	InstructionTextTokenBuilder::FreeInstructionTextTokenList(tokens);
+}
+
+
+// Lifting callbacks run for every instruction, so instead of allocating a wrapper with its own core reference for
+// each call, every thread reuses wrappers that borrow the core function for the duration of the callback. Callbacks
+// can nest (flag IL is requested while an instruction is lifted), so each nesting level has its own wrapper.
+class BorrowedLowLevelILFunction
+{
+	static thread_local vector<unique_ptr<LowLevelILFunction>> m_wrappers;
+	static thread_local size_t m_depth;
+
+	LowLevelILFunction* m_func;
+
+	static unique_ptr<LowLevelILFunction> CreateWrapper()
 	{
-		BNFreeString(tokens[i].text);
-		for (size_t j = 0; j < tokens[j].namesCount; j++)
-			BNFreeString(tokens[i].typeNames[j]);
-		delete[] tokens[i].typeNames;
+		// The internal reference keeps the wrapper alive and does not own a core reference
+		unique_ptr<LowLevelILFunction> func(new LowLevelILFunction((BNLowLevelILFunction*)nullptr));
+		func->AddRefForCallback();
+		return func;
 	}
-	delete[] tokens;
-}
+
+  public:
+	BorrowedLowLevelILFunction(BNLowLevelILFunction* il)
+	{
+		if (m_depth == m_wrappers.size())
+			m_wrappers.push_back(CreateWrapper());
+		m_func = m_wrappers[m_depth++].get();
+		m_func->m_object = il;
+	}
+
+	~BorrowedLowLevelILFunction()
+	{
+		m_depth--;
+		if (m_func->m_refs != 1)
+		{
+			// The callback kept a Ref to the function. Every Ref taken while borrowed added a core reference, so
+			// the wrapper can be handed over to those Refs and a new one used for later callbacks.
+			m_wrappers[m_depth].release();
+			m_wrappers[m_depth] = CreateWrapper();
+			m_func->ReleaseForCallback();
+			return;
+		}
+		m_func->m_object = nullptr;
+	}
+
+	BorrowedLowLevelILFunction(const BorrowedLowLevelILFunction&) = delete;
+	BorrowedLowLevelILFunction& operator=(const BorrowedLowLevelILFunction&) = delete;
+
+	LowLevelILFunction& operator*() const { return *m_func; }
+};
+
+thread_local vector<unique_ptr<LowLevelILFunction>> BorrowedLowLevelILFunction::m_wrappers;
+thread_local size_t BorrowedLowLevelILFunction::m_depth = 0;
 
 
 bool Architecture::GetInstructionLowLevelILCallback(
     void* ctxt, const uint8_t* data, uint64_t addr, size_t* len, BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
+	BorrowedLowLevelILFunction func(il);
 	return arch->GetInstructionLowLevelIL(data, addr, *len, *func);
 }
 
@@ -489,7 +925,7 @@ size_t Architecture::GetFlagWriteLowLevelILCallback(void* ctxt, BNLowLevelILOper
     BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
+	BorrowedLowLevelILFunction func(il);
 	return arch->GetFlagWriteLowLevelIL(op, size, flagWriteType, flag, operands, operandCount, *func);
 }
 
@@ -498,7 +934,7 @@ size_t Architecture::GetFlagConditionLowLevelILCallback(
     void* ctxt, BNLowLevelILFlagCondition cond, uint32_t semClass, BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
+	BorrowedLowLevelILFunction func(il);
 	return arch->GetFlagConditionLowLevelIL(cond, semClass, *func);
 }
 
@@ -506,7 +942,7 @@ size_t Architecture::GetFlagConditionLowLevelILCallback(
 size_t Architecture::GetSemanticFlagGroupLowLevelILCallback(void* ctxt, uint32_t semGroup, BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
+	BorrowedLowLevelILFunction func(il);
 	return arch->GetSemanticFlagGroupLowLevelIL(semGroup, *func);
 }
 
@@ -890,6 +1326,53 @@ Ref<Architecture> Architecture::GetAssociatedArchitectureByAddress(uint64_t&)
 }
 
 
+// Builder that the innermost default vector GetInstructionText on this thread is forwarding to the builder
+// overload. The default builder overload is only handed this exact builder when neither overload is implemented.
+static thread_local const InstructionTextTokenBuilder* g_forwardedInstructionText = nullptr;
+
+
+bool Architecture::GetInstructionText(
+    const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result)
+{
+	InstructionTextTokenBuilder tokens;
+	const InstructionTextTokenBuilder* previous = g_forwardedInstructionText;
+	g_forwardedInstructionText = &tokens;
+	bool ok;
+	try
+	{
+		ok = GetInstructionText(data, addr, len, tokens);
+	}
+	catch (...)
+	{
+		g_forwardedInstructionText = previous;
+		throw;
+	}
+	g_forwardedInstructionText = previous;
+
+	if (ok)
+		result = tokens.ToVector();
+	return ok;
+}
+
+
+bool Architecture::GetInstructionText(
+    const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenBuilder& result)
+{
+	if (&result == g_forwardedInstructionText)
+	{
+		// Called straight from the default vector overload, so neither overload is implemented
+		LogError("Architecture %s does not implement GetInstructionText", GetName().c_str());
+		return false;
+	}
+
+	vector<InstructionTextToken> tokens;
+	if (!GetInstructionText(data, addr, len, tokens))
+		return false;
+	result.Add(tokens);
+	return true;
+}
+
+
 bool Architecture::GetInstructionLowLevelIL(const uint8_t*, uint64_t, size_t&, LowLevelILFunction& il)
 {
 	il.AddInstruction(il.Undefined());
@@ -1085,12 +1568,18 @@ vector<uint32_t> Architecture::GetSystemRegisters()
 
 bool Architecture::IsGlobalRegister(uint32_t reg)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (metadata->registers.Find(reg))
+			return (metadata->registerFlags[reg] & Metadata::GlobalRegister) != 0;
 	return BNIsArchitectureGlobalRegister(m_object, reg);
 }
 
 
 bool Architecture::IsSystemRegister(uint32_t reg)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (metadata->registers.Find(reg))
+			return (metadata->registerFlags[reg] & Metadata::SystemRegister) != 0;
 	return BNIsArchitectureSystemRegister(m_object, reg);
 }
 
@@ -1123,6 +1612,9 @@ BNRegisterStackInfo Architecture::GetRegisterStackInfo(uint32_t)
 
 uint32_t Architecture::GetRegisterStackForRegister(uint32_t reg)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (metadata->registers.Find(reg))
+			return metadata->registerStackForRegister[reg];
 	return BNGetArchitectureRegisterStackForRegister(m_object, reg);
 }
 
@@ -1170,6 +1662,10 @@ vector<uint32_t> Architecture::GetModifiedRegistersOnWrite(uint32_t reg)
 
 uint32_t Architecture::GetRegisterByName(const string& name)
 {
+	uint32_t reg;
+	if (const Metadata* metadata = GetMetadata())
+		if (metadata->FindRegisterByName(name, reg))
+			return reg;
 	return BNGetArchitectureRegisterByName(m_object, name.c_str());
 }
 
@@ -1467,6 +1963,10 @@ bool CoreArchitecture::GetInstructionLowLevelIL(const uint8_t* data, uint64_t ad
 
 string CoreArchitecture::GetRegisterName(uint32_t reg)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->registers.Find(reg))
+			return *name;
+
 	char* name = BNGetArchitectureRegisterName(m_object, reg);
 	string result = name;
 	BNFreeString(name);
@@ -1476,6 +1976,10 @@ string CoreArchitecture::GetRegisterName(uint32_t reg)
 
 string CoreArchitecture::GetFlagName(uint32_t flag)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->flags.Find(flag))
+			return *name;
+
 	char* name = BNGetArchitectureFlagName(m_object, flag);
 	string result = name;
 	BNFreeString(name);
@@ -1485,6 +1989,10 @@ string CoreArchitecture::GetFlagName(uint32_t flag)
 
 string CoreArchitecture::GetFlagWriteTypeName(uint32_t flags)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->flagWriteTypes.Find(flags))
+			return *name;
+
 	char* name = BNGetArchitectureFlagWriteTypeName(m_object, flags);
 	string result = name;
 	BNFreeString(name);
@@ -1494,6 +2002,10 @@ string CoreArchitecture::GetFlagWriteTypeName(uint32_t flags)
 
 string CoreArchitecture::GetSemanticFlagClassName(uint32_t semClass)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->semanticFlagClasses.Find(semClass))
+			return *name;
+
 	char* name = BNGetArchitectureSemanticFlagClassName(m_object, semClass);
 	string result = name;
 	BNFreeString(name);
@@ -1503,6 +2015,10 @@ string CoreArchitecture::GetSemanticFlagClassName(uint32_t semClass)
 
 string CoreArchitecture::GetSemanticFlagGroupName(uint32_t semGroup)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->semanticFlagGroups.Find(semGroup))
+			return *name;
+
 	char* name = BNGetArchitectureSemanticFlagGroupName(m_object, semGroup);
 	string result = name;
 	BNFreeString(name);
@@ -1512,6 +2028,9 @@ string CoreArchitecture::GetSemanticFlagGroupName(uint32_t semGroup)
 
 vector<uint32_t> CoreArchitecture::GetFullWidthRegisters()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->fullWidthRegisters;
+
 	size_t count;
 	uint32_t* regs = BNGetFullWidthArchitectureRegisters(m_object, &count);
 
@@ -1527,6 +2046,9 @@ vector<uint32_t> CoreArchitecture::GetFullWidthRegisters()
 
 vector<uint32_t> CoreArchitecture::GetAllRegisters()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->registers.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureRegisters(m_object, &count);
 
@@ -1542,6 +2064,9 @@ vector<uint32_t> CoreArchitecture::GetAllRegisters()
 
 vector<uint32_t> CoreArchitecture::GetAllFlags()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->flags.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureFlags(m_object, &count);
 
@@ -1557,6 +2082,9 @@ vector<uint32_t> CoreArchitecture::GetAllFlags()
 
 vector<uint32_t> CoreArchitecture::GetAllFlagWriteTypes()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->flagWriteTypes.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureFlagWriteTypes(m_object, &count);
 
@@ -1572,6 +2100,9 @@ vector<uint32_t> CoreArchitecture::GetAllFlagWriteTypes()
 
 vector<uint32_t> CoreArchitecture::GetAllSemanticFlagClasses()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->semanticFlagClasses.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureSemanticFlagClasses(m_object, &count);
 
@@ -1586,6 +2117,9 @@ vector<uint32_t> CoreArchitecture::GetAllSemanticFlagClasses()
 
 vector<uint32_t> CoreArchitecture::GetAllSemanticFlagGroups()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->semanticFlagGroups.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureSemanticFlagGroups(m_object, &count);
 
@@ -1692,24 +2226,34 @@ ExprId CoreArchitecture::GetSemanticFlagGroupLowLevelIL(uint32_t semGroup, LowLe
 
 BNRegisterInfo CoreArchitecture::GetRegisterInfo(uint32_t reg)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (metadata->registers.Find(reg))
+			return metadata->registerInfo[reg];
 	return BNGetArchitectureRegisterInfo(m_object, reg);
 }
 
 
 uint32_t CoreArchitecture::GetStackPointerRegister()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->stackPointer;
 	return BNGetArchitectureStackPointerRegister(m_object);
 }
 
 
 uint32_t CoreArchitecture::GetLinkRegister()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->linkRegister;
 	return BNGetArchitectureLinkRegister(m_object);
 }
 
 
 vector<uint32_t> CoreArchitecture::GetGlobalRegisters()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->globalRegisters;
+
 	size_t count;
 	uint32_t* regs = BNGetArchitectureGlobalRegisters(m_object, &count);
 
@@ -1725,6 +2269,9 @@ vector<uint32_t> CoreArchitecture::GetGlobalRegisters()
 
 vector<uint32_t> CoreArchitecture::GetSystemRegisters()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->systemRegisters;
+
 	size_t count;
 	uint32_t* regs = BNGetArchitectureSystemRegisters(m_object, &count);
 
@@ -1740,6 +2287,10 @@ vector<uint32_t> CoreArchitecture::GetSystemRegisters()
 
 string CoreArchitecture::GetRegisterStackName(uint32_t regStack)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->registerStacks.Find(regStack))
+			return *name;
+
 	char* name = BNGetArchitectureRegisterStackName(m_object, regStack);
 	string result = name;
 	BNFreeString(name);
@@ -1749,6 +2300,9 @@ string CoreArchitecture::GetRegisterStackName(uint32_t regStack)
 
 vector<uint32_t> CoreArchitecture::GetAllRegisterStacks()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->registerStacks.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureRegisterStacks(m_object, &count);
 
@@ -1763,12 +2317,19 @@ vector<uint32_t> CoreArchitecture::GetAllRegisterStacks()
 
 BNRegisterStackInfo CoreArchitecture::GetRegisterStackInfo(uint32_t regStack)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (metadata->registerStacks.Find(regStack))
+			return metadata->registerStackInfo[regStack];
 	return BNGetArchitectureRegisterStackInfo(m_object, regStack);
 }
 
 
 string CoreArchitecture::GetIntrinsicName(uint32_t intrinsic)
 {
+	if (const Metadata* metadata = GetMetadata())
+		if (const string* name = metadata->intrinsics.Find(intrinsic))
+			return *name;
+
 	char* name = BNGetArchitectureIntrinsicName(m_object, intrinsic);
 	string result = name;
 	BNFreeString(name);
@@ -1778,6 +2339,9 @@ string CoreArchitecture::GetIntrinsicName(uint32_t intrinsic)
 
 vector<uint32_t> CoreArchitecture::GetAllIntrinsics()
 {
+	if (const Metadata* metadata = GetMetadata())
+		return metadata->intrinsics.ids;
+
 	size_t count;
 	uint32_t* regs = BNGetAllArchitectureIntrinsics(m_object, &count);
 
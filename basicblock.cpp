@@ -512,3 +512,204 @@ Ref<BasicBlock> BasicBlock::GetSourceBlock() const
 		return nullptr;
 	return new BasicBlock(block);
 }
+
+
+DominatorTree::DominatorTree(const vector<Ref<BasicBlock>>& blocks, bool post) : m_post(post)
+{
+	size_t count = 0;
+	for (auto& block : blocks)
+		count = max(count, block->GetIndex() + 1);
+
+	m_blocks.resize(count);
+	for (auto& block : blocks)
+		m_blocks[block->GetIndex()] = block;
+
+	// Immediate dominators come from the core, everything else is derived here
+	m_idom.assign(count, NoBlock);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!m_blocks[i])
+			continue;
+		BNBasicBlock* dominator = BNGetBasicBlockImmediateDominator(m_blocks[i]->GetObject(), post);
+		if (!dominator)
+			continue;
+		size_t index = BNGetBasicBlockIndex(dominator);
+		BNFreeBasicBlock(dominator);
+		if (index != i && IsValidIndex(index))
+			m_idom[i] = index;
+	}
+
+	// Compute depths by walking up the tree, cutting any cycle so the result is always a forest
+	const size_t unvisited = NoBlock, visiting = NoBlock - 1;
+	m_depth.assign(count, unvisited);
+	vector<size_t> chain;
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t cur = i;
+		while (cur != NoBlock && m_depth[cur] == unvisited)
+		{
+			m_depth[cur] = visiting;
+			chain.push_back(cur);
+			cur = m_idom[cur];
+		}
+		if (cur != NoBlock && m_depth[cur] == visiting)
+		{
+			m_idom[chain.back()] = NoBlock;
+			cur = NoBlock;
+		}
+		size_t depth = (cur == NoBlock) ? 0 : m_depth[cur] + 1;
+		while (!chain.empty())
+		{
+			if (m_idom[chain.back()] == NoBlock)
+				depth = 0;
+			m_depth[chain.back()] = depth++;
+			chain.pop_back();
+		}
+	}
+
+	m_childOffsets.assign(count + 1, 0);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (m_idom[i] != NoBlock)
+			m_childOffsets[m_idom[i] + 1]++;
+	}
+	for (size_t i = 0; i < count; i++)
+		m_childOffsets[i + 1] += m_childOffsets[i];
+	m_children.resize(m_childOffsets[count]);
+	vector<size_t> fill(m_childOffsets.begin(), m_childOffsets.end() - 1);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (m_idom[i] != NoBlock)
+			m_children[fill[m_idom[i]]++] = i;
+	}
+
+	// DFS intervals: a dominates b exactly when b's interval is nested in a's
+	m_enter.assign(count, 0);
+	m_exit.assign(count, 0);
+	size_t clock = 0;
+	vector<pair<size_t, size_t>> stack;
+	for (size_t root = 0; root < count; root++)
+	{
+		if (!m_blocks[root] || m_idom[root] != NoBlock)
+			continue;
+		m_enter[root] = clock++;
+		stack.emplace_back(root, m_childOffsets[root]);
+		while (!stack.empty())
+		{
+			auto& top = stack.back();
+			if (top.second < m_childOffsets[top.first + 1])
+			{
+				size_t child = m_children[top.second++];
+				m_enter[child] = clock++;
+				stack.emplace_back(child, m_childOffsets[child]);
+			}
+			else
+			{
+				m_exit[top.first] = clock++;
+				stack.pop_back();
+			}
+		}
+	}
+
+	// Dominance frontiers: walk up from each predecessor of b (successor for post dominators) until reaching
+	// the immediate dominator of b, every block passed has b in its frontier
+	vector<pair<size_t, size_t>> frontierPairs;
+	for (size_t b = 0; b < count; b++)
+	{
+		if (!m_blocks[b])
+			continue;
+		size_t edgeCount;
+		BNBasicBlockEdge* edges = post ? BNGetBasicBlockOutgoingEdges(m_blocks[b]->GetObject(), &edgeCount) :
+		                                 BNGetBasicBlockIncomingEdges(m_blocks[b]->GetObject(), &edgeCount);
+		for (size_t e = 0; e < edgeCount; e++)
+		{
+			if (!edges[e].target)
+				continue;
+			size_t runner = BNGetBasicBlockIndex(edges[e].target);
+			if (!IsValidIndex(runner))
+				continue;
+			while (runner != NoBlock && runner != m_idom[b])
+			{
+				frontierPairs.emplace_back(runner, b);
+				runner = m_idom[runner];
+			}
+		}
+		BNFreeBasicBlockEdgeList(edges, edgeCount);
+	}
+	sort(frontierPairs.begin(), frontierPairs.end());
+	frontierPairs.erase(unique(frontierPairs.begin(), frontierPairs.end()), frontierPairs.end());
+
+	m_frontierOffsets.assign(count + 1, 0);
+	m_frontiers.reserve(frontierPairs.size());
+	for (auto& i : frontierPairs)
+	{
+		m_frontierOffsets[i.first + 1]++;
+		m_frontiers.push_back(i.second);
+	}
+	for (size_t i = 0; i < count; i++)
+		m_frontierOffsets[i + 1] += m_frontierOffsets[i];
+}
+
+
+vector<size_t> DominatorTree::GetIteratedDominanceFrontier(const vector<size_t>& blocks) const
+{
+	size_t words = (m_blocks.size() + 63) / 64;
+	vector<uint64_t> inFrontier(words, 0);
+	vector<uint64_t> queued(words, 0);
+	vector<size_t> worklist;
+	for (size_t block : blocks)
+	{
+		if (!IsValidIndex(block) || (queued[block / 64] & (1ULL << (block % 64))))
+			continue;
+		queued[block / 64] |= 1ULL << (block % 64);
+		worklist.push_back(block);
+	}
+
+	while (!worklist.empty())
+	{
+		size_t block = worklist.back();
+		worklist.pop_back();
+		for (size_t frontier : GetDominanceFrontier(block))
+		{
+			uint64_t bit = 1ULL << (frontier % 64);
+			inFrontier[frontier / 64] |= bit;
+			if (!(queued[frontier / 64] & bit))
+			{
+				queued[frontier / 64] |= bit;
+				worklist.push_back(frontier);
+			}
+		}
+	}
+
+	vector<size_t> result;
+	for (size_t word = 0; word < words; word++)
+	{
+		for (uint64_t bits = inFrontier[word]; bits; bits &= bits - 1)
+		{
+			size_t bit = 0;
+			while (!(bits & (1ULL << bit)))
+				bit++;
+			result.push_back(word * 64 + bit);
+		}
+	}
+	return result;
+}
+
+
+size_t DominatorTree::GetCommonDominator(size_t a, size_t b) const
+{
+	if (!IsValidIndex(a) || !IsValidIndex(b))
+		return NoBlock;
+	while (m_depth[a] > m_depth[b])
+		a = m_idom[a];
+	while (m_depth[b] > m_depth[a])
+		b = m_idom[b];
+	while (a != b)
+	{
+		a = m_idom[a];
+		b = m_idom[b];
+		if (a == NoBlock || b == NoBlock)
+			return NoBlock;
+	}
+	return a;
+}
@@ -19,6 +19,8 @@
 // IN THE SOFTWARE.
 
 #include "binaryninjaapi.h"
+#include <condition_variable>
+#include <deque>
 #include <numeric>
 
 using namespace BinaryNinja;
@@ -361,6 +363,153 @@ void BinaryNinja::SetWorkerThreadCount(size_t count)
 }
 
 
+struct TaskGroup::State
+{
+	string name;
+	mutex lock;
+	condition_variable finished;
+	deque<function<void()>> queued;
+	size_t pending = 0;
+	atomic<bool> cancelled {false};
+	exception_ptr error;
+
+	// Run one queued task if there is one, returns false when the queue is empty
+	bool RunNext()
+	{
+		function<void()> task;
+		{
+			lock_guard<mutex> guard(lock);
+			if (queued.empty())
+				return false;
+			task = std::move(queued.front());
+			queued.pop_front();
+		}
+
+		if (!cancelled)
+		{
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+				lock_guard<mutex> guard(lock);
+				if (!error)
+					error = current_exception();
+				cancelled = true;
+			}
+		}
+
+		lock_guard<mutex> guard(lock);
+		if (--pending == 0)
+			finished.notify_all();
+		return true;
+	}
+};
+
+
+TaskGroup::TaskGroup(const string& name) : m_state(make_shared<State>())
+{
+	m_state->name = name;
+}
+
+
+TaskGroup::~TaskGroup()
+{
+	try
+	{
+		Wait();
+	}
+	catch (...)
+	{
+		// Exceptions are only reported to explicit calls to Wait
+	}
+}
+
+
+void TaskGroup::Run(const function<void()>& task)
+{
+	{
+		lock_guard<mutex> guard(m_state->lock);
+		m_state->queued.push_back(task);
+		m_state->pending++;
+	}
+
+	// Worker actions only pick up the next queued task, which may already have been taken by a waiting thread
+	shared_ptr<State> state = m_state;
+	WorkerEnqueue([state]() { state->RunNext(); }, m_state->name);
+}
+
+
+void TaskGroup::Wait()
+{
+	while (m_state->RunNext())
+		;
+
+	unique_lock<mutex> guard(m_state->lock);
+	m_state->finished.wait(guard, [&]() { return m_state->pending == 0; });
+	if (m_state->error)
+	{
+		exception_ptr error = m_state->error;
+		m_state->error = nullptr;
+		rethrow_exception(error);
+	}
+}
+
+
+void TaskGroup::Cancel()
+{
+	m_state->cancelled = true;
+}
+
+
+bool TaskGroup::IsCancelled() const
+{
+	return m_state->cancelled;
+}
+
+
+bool BinaryNinja::ParallelForChunks(size_t begin, size_t end, size_t grain,
+    const function<void(size_t chunk, size_t chunkBegin, size_t chunkEnd)>& func,
+    const function<bool(size_t current, size_t total)>& progress)
+{
+	if (begin >= end)
+		return true;
+
+	size_t threads = max<size_t>(GetWorkerThreadCount(), 1);
+	size_t count = end - begin;
+	if (grain == 0)
+		grain = max<size_t>(count / (threads * 8), 1);
+	size_t chunks = (count + grain - 1) / grain;
+
+	TaskGroup group("ParallelFor");
+	atomic<size_t> nextChunk(0);
+	atomic<size_t> completed(0);
+	mutex progressMutex;
+
+	// Each task keeps claiming chunks until none are left, so the work balances across threads
+	auto runner = [&]() {
+		while (!group.IsCancelled())
+		{
+			size_t chunk = nextChunk++;
+			if (chunk >= chunks)
+				break;
+			size_t chunkBegin = begin + chunk * grain;
+			func(chunk, chunkBegin, min(chunkBegin + grain, end));
+
+			lock_guard<mutex> guard(progressMutex);
+			size_t done = ++completed;
+			if (progress && !progress(done, chunks))
+				group.Cancel();
+		}
+	};
+	for (size_t i = 0; i < min(threads, chunks); i++)
+		group.Run(runner);
+	group.Wait();
+	return completed == chunks;
+}
+
+
 string BinaryNinja::GetUniqueIdentifierString()
 {
 	char* str = BNGetUniqueIdentifierString();
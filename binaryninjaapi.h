@@ -32,12 +32,15 @@
 #include <unordered_map>
 #include <exception>
 #include <functional>
+#include <future>
 #include <set>
 #include <mutex>
 #include <atomic>
 #include <memory>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
+#include <algorithm>
 #include <variant>
 #include <optional>
 #include <memory>
@@ -1313,6 +1316,106 @@ namespace BinaryNinja {
 	bool DemangleGNU3(Ref<Architecture> arch, const std::string& mangledName, Ref<Type>& outType,
 		QualifiedName& outVarName, BinaryView* view);
 
+	/*! Mangling scheme expected by DemangleBatch
+
+		\ingroup demangle
+	*/
+	enum DemangleStyle
+	{
+		AutoDemangleStyle,  //!< Names starting with '?' are demangled as MS, everything else as GNU3
+		MSDemangleStyle,
+		GNU3DemangleStyle
+	};
+
+	/*! Options for DemangleBatch
+
+		\ingroup demangle
+	*/
+	struct DemangleBatchOptions
+	{
+		DemangleStyle style = AutoDemangleStyle;
+		bool simplify = false;   //!< Whether to simplify demangled names
+		bool parallel = true;    //!< Whether large batches may be split across the worker thread pool
+
+		/*! Options using the view's "analysis.types.templateSimplifier" setting, read once for the whole batch
+
+			\param[in] view View to check the analysis.types.templateSimplifier for
+			\param[in] style Mangling scheme of the names
+		*/
+		static DemangleBatchOptions ForView(BinaryView* view, DemangleStyle style = AutoDemangleStyle);
+	};
+
+	/*! Results of DemangleBatch, indexed like the input names
+
+		Name components of every result are stored back to back in a single buffer, and repeated input names
+		share one entry, so a large batch costs a handful of allocations rather than several per name.
+
+		\ingroup demangle
+	*/
+	class DemangleBatchResult
+	{
+		struct Entry
+		{
+			bool demangled;
+			size_t firstComponent;
+			size_t componentCount;
+			size_t typeIndex;
+		};
+
+		std::vector<char> m_text;
+		std::vector<size_t> m_componentOffsets;
+		std::vector<Ref<Type>> m_types;
+		std::vector<Entry> m_entries;
+		std::vector<size_t> m_entryForName;
+
+		friend DemangleBatchResult DemangleBatch(
+		    Architecture* arch, const std::vector<std::string>& names, const DemangleBatchOptions& options);
+
+	  public:
+		size_t GetCount() const { return m_entryForName.size(); }
+		bool IsDemangled(size_t i) const { return m_entries[m_entryForName[i]].demangled; }
+
+		/*! Demangled type of name \c i, or nullptr if it has none */
+		Ref<Type> GetType(size_t i) const;
+
+		size_t GetComponentCount(size_t i) const { return m_entries[m_entryForName[i]].componentCount; }
+
+		/*! Component of the demangled name, valid for the lifetime of this object */
+		const char* GetComponent(size_t i, size_t component) const
+		{
+			return &m_text[m_componentOffsets[m_entries[m_entryForName[i]].firstComponent + component]];
+		}
+
+		QualifiedName GetName(size_t i) const;
+	};
+
+	/*! Demangles a list of names
+
+		Settings are taken from \c options once for the whole batch, repeated names are demangled once, and results
+		are kept in a process wide LRU cache so names seen by earlier batches are not demangled again. Large
+		batches are split across the worker thread pool.
+
+		\param[in] arch Architecture for the symbols. Required for pointer and integer sizes.
+		\param[in] names Mangled names
+		\param[in] options Mangling scheme and simplification options
+		\return Results indexed like \c names
+
+		\ingroup demangle
+	*/
+	DemangleBatchResult DemangleBatch(
+	    Architecture* arch, const std::vector<std::string>& names, const DemangleBatchOptions& options = {});
+
+	/*! Set the number of names kept in the DemangleBatch cache, 0 disables it
+
+		\ingroup demangle
+	*/
+	void SetDemangleCacheSize(size_t entries);
+
+	/*!
+		\ingroup demangle
+	*/
+	void ClearDemangleCache();
+
 	/*! Determines if a symbol name is a mangled GNU3 name
 
 	    \param[in] mangledName a potentially mangled name
@@ -1338,6 +1441,49 @@ namespace BinaryNinja {
 	*/
 	void ExecuteOnMainThreadAndWait(const std::function<void()>& action);
 
+	/*! Counters for the coalescing main thread queue used by ExecuteOnMainThreadCoalesced
+
+		\ingroup mainthread
+	*/
+	struct MainThreadQueueStats
+	{
+		size_t pending;         //!< Actions waiting to run
+		uint64_t posted;        //!< Actions posted since startup
+		uint64_t coalesced;     //!< Posted actions that replaced a pending action with the same key
+		uint64_t executed;      //!< Actions that have run
+		uint64_t drains;        //!< Main thread callbacks used to run the actions
+		uint64_t maxLatencyUs;  //!< Longest time from posting an action to running it, in microseconds
+		uint64_t totalLatencyUs;
+	};
+
+	/*! Queue an action to run on the main thread, replacing any pending action posted with the same key.
+
+		Actions run in the order their key was first queued. The queue is drained by a single main thread callback
+		that runs actions until the time budget set by SetMainThreadQueueBudget is used up, then yields and
+		schedules another pass for the rest. Exceptions thrown by an action are logged and do not stop the queue.
+
+		@threadsafe
+		\ingroup mainthread
+
+		\param key Coalescing key, an empty key never coalesces
+		\param action Action to run
+	*/
+	void ExecuteOnMainThreadCoalesced(const std::string& key, const std::function<void()>& action);
+
+	/*! Set the time budget for each pass over the coalescing main thread queue, in microseconds. At least one
+		action runs per pass regardless of the budget.
+
+		@threadsafe
+		\ingroup mainthread
+	*/
+	void SetMainThreadQueueBudget(uint64_t microseconds);
+
+	/*!
+		@threadsafe
+		\ingroup mainthread
+	*/
+	MainThreadQueueStats GetMainThreadQueueStats();
+
 	/*!
 		@threadsafe
 		\ingroup mainthread
@@ -1379,6 +1525,66 @@ namespace BinaryNinja {
 	*/
 	void WorkerInteractiveEnqueue(RefCountObject* owner, const std::function<void()>& action, const std::string& name = "");
 
+	/*! Store the result of calling \c func, or the exception it throws, in \c promise
+
+		\ingroup mainthread
+	*/
+	template <typename R, typename F>
+	void FulfillPromise(std::promise<R>& promise, F& func)
+	{
+		try
+		{
+			if constexpr (std::is_void<R>::value)
+			{
+				func();
+				promise.set_value();
+			}
+			else
+			{
+				promise.set_value(func());
+			}
+		}
+		catch (...)
+		{
+			promise.set_exception(std::current_exception());
+		}
+	}
+
+	/*! Run \c func on the main thread without waiting for it. The returned future holds the result of \c func,
+		or rethrows the exception it threw from \c get().
+
+		@threadsafe
+		\ingroup mainthread
+	*/
+	template <typename F>
+	std::future<std::invoke_result_t<F>> ExecuteOnMainThreadAsync(F&& func)
+	{
+		using R = std::invoke_result_t<F>;
+		auto promise = std::make_shared<std::promise<R>>();
+		std::future<R> result = promise->get_future();
+		ExecuteOnMainThread([promise, func = std::forward<F>(func)]() mutable { FulfillPromise(*promise, func); });
+		return result;
+	}
+
+	/*! Run \c func on a worker thread. The returned future holds the result of \c func, or rethrows the exception
+		it threw from \c get().
+
+		\note Waiting on the future from a worker thread occupies that thread; prefer TaskGroup for fan-out work
+		that is waited on from worker threads.
+
+		@threadsafe
+		\ingroup mainthread
+	*/
+	template <typename F>
+	std::future<std::invoke_result_t<F>> WorkerEnqueueAsync(F&& func, const std::string& name = "")
+	{
+		using R = std::invoke_result_t<F>;
+		auto promise = std::make_shared<std::promise<R>>();
+		std::future<R> result = promise->get_future();
+		WorkerEnqueue([promise, func = std::forward<F>(func)]() mutable { FulfillPromise(*promise, func); }, name);
+		return result;
+	}
+
 	/*!
 		@threadsafe
 		\ingroup mainthread
@@ -1391,6 +1597,110 @@ namespace BinaryNinja {
 	*/
 	void SetWorkerThreadCount(size_t count);
 
+	/*! TaskGroup runs a set of tasks on the worker thread pool and allows waiting for all of them to finish.
+
+		A thread calling Wait runs tasks of the group that have not been started yet instead of just blocking,
+		so a group can be waited on from a worker thread without exhausting the pool. If a task throws, the
+		group is cancelled and the first exception is rethrown from Wait. Cancel drops tasks that have not
+		started; running tasks can poll IsCancelled to stop early.
+
+		@threadsafe
+		\ingroup mainthread
+	*/
+	class TaskGroup
+	{
+		struct State;
+		std::shared_ptr<State> m_state;
+
+	  public:
+		TaskGroup(const std::string& name = "");
+		~TaskGroup();
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		void Run(const std::function<void()>& task);
+
+		/*! Wait for every task to finish
+
+			\throws The first exception thrown by a task
+		*/
+		void Wait();
+
+		void Cancel();
+		bool IsCancelled() const;
+	};
+
+	/*! Split the range [begin, end) into chunks of \c grain items and call \c func for each chunk on the worker
+		thread pool. Chunks are claimed dynamically, so threads that finish early take over remaining work.
+
+		\param begin First index
+		\param end One past the last index
+		\param grain Number of indices per chunk, or 0 to pick one from the worker count
+		\param func Called with the chunk number and the index range of the chunk
+		\param progress Progress callback called as chunks complete, such as one made with SplitProgress. Returning
+		       false cancels chunks that have not started.
+		\return Whether every chunk ran
+		\throws The first exception thrown by \c func
+	*/
+	bool ParallelForChunks(size_t begin, size_t end, size_t grain,
+	    const std::function<void(size_t chunk, size_t chunkBegin, size_t chunkEnd)>& func,
+	    const std::function<bool(size_t current, size_t total)>& progress = {});
+
+	/*! Call \c func for each index in [begin, end) on the worker thread pool
+
+		\see ParallelForChunks
+	*/
+	template <typename F>
+	bool ParallelFor(size_t begin, size_t end, size_t grain, const F& func,
+	    const std::function<bool(size_t current, size_t total)>& progress = {})
+	{
+		return ParallelForChunks(
+		    begin, end, grain,
+		    [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+			    for (size_t i = chunkBegin; i < chunkEnd; i++)
+				    func(i);
+		    },
+		    progress);
+	}
+
+	/*! Compute <tt>combine(...combine(combine(identity, map(begin)), map(begin + 1))..., map(end - 1))</tt> on the
+		worker thread pool. Each chunk is reduced separately and the partial results are combined in index order,
+		so the result does not depend on scheduling.
+
+		\return The combined result, or \c std::nullopt if \c progress cancelled the reduction before every chunk ran
+		\see ParallelForChunks
+	*/
+	template <typename T, typename Map, typename Combine>
+	std::optional<T> ParallelReduce(size_t begin, size_t end, size_t grain, const T& identity, const Map& map,
+	    const Combine& combine, const std::function<bool(size_t current, size_t total)>& progress = {})
+	{
+		std::vector<std::optional<T>> partials;
+		std::mutex partialsMutex;
+		bool completed = ParallelForChunks(
+		    begin, end, grain,
+		    [&](size_t chunk, size_t chunkBegin, size_t chunkEnd) {
+			    T value = identity;
+			    for (size_t i = chunkBegin; i < chunkEnd; i++)
+				    value = combine(value, map(i));
+			    std::lock_guard<std::mutex> lock(partialsMutex);
+			    if (partials.size() <= chunk)
+				    partials.resize(chunk + 1);
+			    partials[chunk] = std::move(value);
+		    },
+		    progress);
+		if (!completed)
+			return std::nullopt;
+
+		T result = identity;
+		for (auto& i : partials)
+		{
+			if (i)
+				result = combine(result, *i);
+		}
+		return result;
+	}
+
 	/*!
 	    @threadsafe
 	*/
@@ -1680,12 +1990,64 @@ namespace BinaryNinja {
 
 	std::map<std::string, uint64_t> GetMemoryUsageInfo();
 
-	/*!
+	/*! Non-owning view of a contiguous range of bytes, such as the contents of a DataBuffer. The view does not
+		keep the underlying memory alive and is invalidated by any operation that resizes the source.
+
+		\ingroup databuffer
+	*/
+	class DataBufferView
+	{
+		const uint8_t* m_data;
+		size_t m_length;
+
+	  public:
+		DataBufferView() : m_data(nullptr), m_length(0) {}
+		DataBufferView(const void* data, size_t len) : m_data((const uint8_t*)data), m_length(len) {}
+
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetLength() const { return m_length; }
+		bool IsEmpty() const { return m_length == 0; }
+
+		const uint8_t* begin() const { return m_data; }
+		const uint8_t* end() const { return m_data + m_length; }
+		const uint8_t& operator[](size_t offset) const { return m_data[offset]; }
+
+		/*! Get a view of a subrange of this view, clamped to its bounds
+
+			\param start Offset of the first byte
+			\param len Maximum number of bytes in the result
+		*/
+		DataBufferView GetSlice(size_t start, size_t len) const
+		{
+			if (start > m_length)
+				start = m_length;
+			return DataBufferView(m_data + start, std::min(len, m_length - start));
+		}
+
+		/*! Copy the viewed bytes into a new DataBuffer */
+		DataBuffer ToDataBuffer() const;
+	};
+
+	/*! DataBuffer is a resizable byte buffer that can be passed to the core.
+
+		Buffers of up to \c InlineCapacity bytes are stored inline without allocating, and the backing core object is
+		only created when it is needed, such as by GetBufferObject or growing beyond the inline capacity. Moving a
+		DataBuffer never allocates.
+
 		\ingroup databuffer
 	*/
 	class DataBuffer
 	{
-		BNDataBuffer* m_buffer;
+	  public:
+		static constexpr size_t InlineCapacity = 23;
+
+	  private:
+		// When m_buffer is set it holds the contents, otherwise they are stored in m_inline
+		mutable BNDataBuffer* m_buffer;
+		uint8_t m_inline[InlineCapacity];
+		uint8_t m_inlineLength;
+
+		void Materialize() const;
 
 	  public:
 		DataBuffer();
@@ -1699,7 +2061,11 @@ namespace BinaryNinja {
 		DataBuffer& operator=(const DataBuffer& buf);
 		DataBuffer& operator=(DataBuffer&& buf);
 
-		BNDataBuffer* GetBufferObject() const { return m_buffer; }
+		/*! Get the core object for this buffer, creating it if the contents are currently stored inline
+
+			@threadunsafe
+		*/
+		BNDataBuffer* GetBufferObject() const;
 
 		/*! Get the raw pointer to the data contained within this buffer
 
@@ -1776,6 +2142,12 @@ namespace BinaryNinja {
 		*/
 		DataBuffer GetSlice(size_t start, size_t len);
 
+		/*! Get a non-owning view of the contents of this buffer
+
+			@threadunsafe
+		*/
+		DataBufferView GetView() const { return DataBufferView(GetData(), GetLength()); }
+
 		uint8_t& operator[](size_t offset);
 		const uint8_t& operator[](size_t offset) const;
 
@@ -1991,6 +2363,86 @@ namespace BinaryNinja {
 		    const BNInstructionTextToken* tokens, size_t count);
 	};
 
+	/*! InstructionTextTokenBuilder collects instruction text tokens without allocating a string per token.
+
+		Token text is appended to a buffer owned by the builder, or referenced directly when added with AddInterned.
+		A builder can be cleared and reused, so its buffers are only allocated once. CreateInstructionTextTokenList
+		emits all tokens and their strings in a single allocation that is released with one call to
+		FreeInstructionTextTokenList.
+
+		\code{.cpp}
+		static const char* r0 = InstructionTextTokenBuilder::Intern("r0");
+		result.AddInterned(InstructionToken, "mov").AddInterned(TextToken, " ").AddInterned(RegisterToken, r0);
+		\endcode
+
+		\ingroup architectures
+	*/
+	class InstructionTextTokenBuilder
+	{
+		struct TokenText
+		{
+			const char* interned;
+			size_t offset;
+			size_t length;
+			size_t firstName;
+			size_t nameCount;
+		};
+
+		std::vector<BNInstructionTextToken> m_tokens;
+		std::vector<TokenText> m_text;
+		std::vector<std::pair<size_t, size_t>> m_names;  // Offset and length in m_strings
+		std::vector<char> m_strings;
+
+		size_t StoreString(const char* text, size_t len);
+		InstructionTextTokenBuilder& AddToken(BNInstructionTextTokenType type, const TokenText& text, uint64_t value,
+		    size_t size, size_t operand, uint8_t confidence, uint64_t width);
+
+	  public:
+		/*! Get a copy of a string that is never freed, for use with AddInterned
+
+			\param text String to intern
+			\return Pointer to the interned string, identical for equal strings
+		*/
+		static const char* Intern(const std::string& text);
+
+		/*! Remove all tokens, keeping the allocated buffers */
+		void Clear();
+		size_t GetCount() const { return m_tokens.size(); }
+		bool IsEmpty() const { return m_tokens.empty(); }
+
+		/*! Add a token, copying its text into the builder */
+		InstructionTextTokenBuilder& Add(BNInstructionTextTokenType type, const std::string& text, uint64_t value = 0,
+		    size_t size = 0, size_t operand = BN_INVALID_OPERAND, uint8_t confidence = BN_FULL_CONFIDENCE,
+		    uint64_t width = InstructionTextToken::WidthIsByteCount);
+
+		/*! Add a token referencing its text without a copy
+
+			\param text Text that outlives all token lists created from the builder, such as a string literal or the
+			            result of Intern
+		*/
+		InstructionTextTokenBuilder& AddInterned(BNInstructionTextTokenType type, const char* text, uint64_t value = 0,
+		    size_t size = 0, size_t operand = BN_INVALID_OPERAND, uint8_t confidence = BN_FULL_CONFIDENCE,
+		    uint64_t width = InstructionTextToken::WidthIsByteCount);
+
+		InstructionTextTokenBuilder& Add(const InstructionTextToken& token);
+		InstructionTextTokenBuilder& Add(const std::vector<InstructionTextToken>& tokens);
+
+		/*! Set the context and address of the last added token */
+		InstructionTextTokenBuilder& SetContext(BNInstructionTextTokenContext context, uint64_t address = 0);
+
+		/*! Append a type name to the last added token */
+		InstructionTextTokenBuilder& AddTypeName(const std::string& name);
+
+		std::vector<InstructionTextToken> ToVector() const;
+
+		/*! Create a token list owning copies of the builder strings
+
+			\return Token list, to be freed with FreeInstructionTextTokenList
+		*/
+		BNInstructionTextToken* CreateInstructionTextTokenList() const;
+		static void FreeInstructionTextTokenList(BNInstructionTextToken* tokens);
+	};
+
 	struct UndoEntry;
 
 	/*!
@@ -2478,6 +2930,11 @@ namespace BinaryNinja {
 		static void ComponentDataVariableAddedCallback(void* ctxt, BNBinaryView* data, BNComponent* component, BNDataVariable* var);
 		static void ComponentDataVariableRemovedCallback(void* ctxt, BNBinaryView* data, BNComponent* component, BNDataVariable* var);
 
+		// Objects handed to the callbacks borrow the core handle for the duration of the callback and are reused by
+		// later callbacks on the same thread instead of being allocated for each event
+		template <typename T>
+		class BorrowedObject;
+
 	  public:
 
 		enum NotificationType : uint64_t
@@ -2829,6 +3286,104 @@ namespace BinaryNinja {
 		}
 	};
 
+	/*! Kind of data change recorded in a BinaryDataNotificationBatch
+
+		\ingroup binaryview
+	*/
+	enum BinaryDataUpdateType
+	{
+		DataWrittenUpdate,
+		DataInsertedUpdate,
+		DataRemovedUpdate
+	};
+
+	/*!
+		\ingroup binaryview
+	*/
+	struct BinaryDataUpdateRange
+	{
+		BinaryDataUpdateType type;
+		uint64_t offset;
+		uint64_t length;
+	};
+
+	/*! Events collected by a BatchedBinaryDataNotification between two flushes
+
+		\ingroup binaryview
+	*/
+	struct BinaryDataNotificationBatch
+	{
+		/*! Data changes in the order they happened. Overlapping and adjacent writes between two insertions or
+			removals are merged and sorted by offset, and contiguous insertions or removals are merged.
+		*/
+		std::vector<BinaryDataUpdateRange> dataUpdates;
+		std::vector<Ref<Function>> updatedFunctions;  //!< Each updated function once, in order of first update
+		std::vector<Ref<Symbol>> addedSymbols;
+
+		bool IsEmpty() const { return dataUpdates.empty() && updatedFunctions.empty() && addedSymbols.empty(); }
+	};
+
+	/*! BatchedBinaryDataNotification buffers data writes, insertions and removals, function updates and symbol
+		additions, and delivers them in a single OnBinaryDataBatch call on each NotificationBarrier.
+
+		The barrier is rescheduled every \c flushInterval milliseconds while events keep arriving, and quiesces when
+		a flush finds nothing to deliver. Other notification types are delivered immediately as usual. Functions in
+		a batch may have been removed from the view after they were last updated.
+
+		\ingroup binaryview
+	*/
+	class BatchedBinaryDataNotification : public BinaryDataNotification
+	{
+		struct PendingBatch
+		{
+			BinaryDataNotificationBatch batch;
+			std::map<uint64_t, uint64_t> writes;
+			std::set<BNFunction*> functions;
+			std::set<BNSymbol*> symbols;
+		};
+
+		std::mutex m_batchMutex;
+		std::map<BNBinaryView*, PendingBatch> m_pending;
+		uint64_t m_flushInterval;
+
+		static void FlushPendingWrites(PendingBatch& pending);
+		void AddDataUpdate(BinaryView* view, BinaryDataUpdateType type, uint64_t offset, uint64_t len);
+
+	  public:
+		BatchedBinaryDataNotification(
+		    NotificationTypes notifications = BinaryDataUpdates | FunctionUpdated | SymbolAdded,
+		    uint64_t flushInterval = 250);
+		virtual ~BatchedBinaryDataNotification();
+
+		uint64_t GetFlushInterval() const { return m_flushInterval; }
+		void SetFlushInterval(uint64_t interval) { m_flushInterval = interval; }
+
+		/*! Deliver the events buffered for \c view now instead of waiting for the next barrier
+
+			\param view BinaryView to flush
+			\return Whether there were any events to deliver
+		*/
+		bool FlushBatch(BinaryView* view);
+
+		/*! This notification is posted with the events buffered since the previous flush
+
+			\param view BinaryView the events happened in
+			\param batch Coalesced events, never empty
+		*/
+		virtual void OnBinaryDataBatch(BinaryView* view, const BinaryDataNotificationBatch& batch)
+		{
+			(void)view;
+			(void)batch;
+		}
+
+		uint64_t OnNotificationBarrier(BinaryView* view) override;
+		void OnBinaryDataWritten(BinaryView* view, uint64_t offset, size_t len) override;
+		void OnBinaryDataInserted(BinaryView* view, uint64_t offset, size_t len) override;
+		void OnBinaryDataRemoved(BinaryView* view, uint64_t offset, uint64_t len) override;
+		void OnAnalysisFunctionUpdated(BinaryView* view, Function* func) override;
+		void OnSymbolAdded(BinaryView* view, Symbol* sym) override;
+	};
+
 	/*!
 		\ingroup fileaccessor
 	*/
@@ -2870,6 +3425,68 @@ namespace BinaryNinja {
 		virtual size_t Write(uint64_t offset, const void* src, size_t len) override;
 	};
 
+	/*! Expected access pattern for a MmapFileAccessor, used as a hint to the operating system
+
+		\ingroup fileaccessor
+	*/
+	enum MmapAccessPattern
+	{
+		NormalMmapAccess,
+		SequentialMmapAccess,  //!< Front to back scans, such as while a loader parses the file
+		RandomMmapAccess       //!< Scattered reads, such as during analysis
+	};
+
+	/*! MmapFileAccessor is a read-only FileAccessor backed by a memory mapping of the file. Reads are served by
+		copying from the mapping, and GetRange gives callers that can use it direct access without a copy.
+		Writes are not supported and always return 0.
+
+		\ingroup fileaccessor
+	*/
+	class MmapFileAccessor : public FileAccessor
+	{
+		const uint8_t* m_data;
+		uint64_t m_length;
+		bool m_valid;
+#ifdef WIN32
+		HANDLE m_file;
+		HANDLE m_mapping;
+#else
+		int m_fd;
+#endif
+
+	  public:
+		/*! Map a file read-only
+
+			\param path Path of the file to map
+			\param pattern Initial access pattern hint
+		*/
+		MmapFileAccessor(const std::string& path, MmapAccessPattern pattern = NormalMmapAccess);
+		virtual ~MmapFileAccessor();
+
+		MmapFileAccessor(const MmapFileAccessor&) = delete;
+		MmapFileAccessor& operator=(const MmapFileAccessor&) = delete;
+
+		/*! Change the access pattern hint for the mapping, for example once loading is done and analysis starts.
+			This has no effect on platforms without a way to advise the kernel about an existing mapping.
+		*/
+		void SetAccessPattern(MmapAccessPattern pattern);
+
+		/*! Get a pointer to the start of the mapped file, valid for the lifetime of this object */
+		const uint8_t* GetData() const { return m_data; }
+
+		/*! Get a view of the mapped bytes without copying, clamped to the end of the file
+
+			\param offset Offset of the first byte
+			\param len Maximum number of bytes in the view
+		*/
+		DataBufferView GetRange(uint64_t offset, size_t len) const;
+
+		virtual bool IsValid() const override { return m_valid; }
+		virtual uint64_t GetLength() const override { return m_length; }
+		virtual size_t Read(void* dest, uint64_t offset, size_t len) override;
+		virtual size_t Write(uint64_t offset, const void* src, size_t len) override;
+	};
+
 	class Function;
 	class BasicBlock;
 
@@ -3441,6 +4058,34 @@ namespace BinaryNinja {
 		QueryMetadataException(const std::string& error) : ExceptionWithStackTrace(error) {}
 	};
 
+	/*! Byte pattern for BinaryView::FindAllPatterns. A data byte matches position \c i when
+		<tt>(data & mask[i]) == (bytes[i] & mask[i])</tt>. An empty mask requires every byte to match exactly.
+
+		\ingroup binaryview
+	*/
+	struct BinaryPattern
+	{
+		std::vector<uint8_t> bytes;
+		std::vector<uint8_t> mask;
+
+		/*! Parse a pattern from hex text such as <tt>"48 8b ?? 05 4?"</tt>, where \c ? is a wildcard nibble
+
+			\param text Pattern text, whitespace between bytes is optional
+			\param[out] result Parsed pattern
+			\return Whether the text was a valid pattern
+		*/
+		static bool FromString(const std::string& text, BinaryPattern& result);
+	};
+
+	/*!
+		\ingroup binaryview
+	*/
+	struct BinaryPatternMatch
+	{
+		size_t patternId;  //!< Index of the matching pattern
+		uint64_t address;
+	};
+
 	/*! \c BinaryView implements a view on binary data, and presents a queryable interface of a binary file.
 
 		One key job of BinaryView is file format parsing which allows Binary Ninja to read, write, insert, remove portions
@@ -3504,6 +4149,8 @@ namespace BinaryNinja {
 	*/
 	class BinaryView : public CoreRefCountObject<BNBinaryView, BNNewViewReference, BNFreeBinaryView>
 	{
+		friend class BinaryDataNotification;
+
 	  protected:
 		Ref<FileMetadata> m_file;  //!< The underlying file
 
@@ -5272,6 +5919,23 @@ namespace BinaryNinja {
 		    BNFunctionGraphType graph, const std::function<bool(size_t current, size_t total)>& progress,
 		    const std::function<bool(uint64_t addr, const LinearDisassemblyLine& line)>& matchCallback);
 
+		/*! Search for many byte patterns in a single pass
+
+			The readable parts of the range are scanned in parallel chunks. Matches are delivered on the calling
+			thread in address order, and for a single address in pattern order. Matches never span a gap between
+			segments.
+
+			\param start Start of the range to search
+			\param end End of the range to search
+			\param patterns Patterns to search for, identified by their index in the vector
+			\param progress Progress callback, return false to cancel the search
+			\param matchCallback Called for each match, return false to stop the search
+			\return Whether the search ran to completion
+		*/
+		bool FindAllPatterns(uint64_t start, uint64_t end, const std::vector<BinaryPattern>& patterns,
+		    const std::function<bool(size_t current, size_t total)>& progress,
+		    const std::function<bool(const BinaryPatternMatch& match)>& matchCallback);
+
 		void Reanalyze();
 
 		Ref<Workflow> GetWorkflow() const;
@@ -6225,6 +6889,228 @@ namespace BinaryNinja {
 		bool IsEndOfFile() const;
 	};
 
+	/*! BufferedBinaryReader reads from a BinaryView through a local window of data fetched in blocks of
+		\c windowSize bytes, so that consecutive small reads do not each call into the core. Integers are decoded
+		inline with the reader's endianness.
+
+		Data is cached when a window is fetched: call Invalidate after modifying the view to observe the changes.
+		Each throwing read has a non-throwing Try variant which leaves the cursor unchanged on failure.
+
+		\ingroup binaryview
+	*/
+	class BufferedBinaryReader
+	{
+		Ref<BinaryView> m_view;
+		BNEndianness m_endian;
+		size_t m_addressSize;
+		uint64_t m_offset;
+		std::vector<uint8_t> m_window;
+		uint64_t m_windowStart;
+		size_t m_windowLength;
+
+		bool FillWindow(uint64_t offset, size_t len);
+		bool TryReadUnbuffered(void* dest, size_t len);
+
+		bool IsBuffered(uint64_t offset, size_t len) const
+		{
+			return (offset >= m_windowStart) && (offset - m_windowStart <= m_windowLength)
+			    && (m_windowLength - (offset - m_windowStart) >= len);
+		}
+
+		template <typename T>
+		static T DecodeInteger(const uint8_t* data, BNEndianness endian)
+		{
+			static_assert(std::is_integral<T>::value, "DecodeInteger requires an integer type");
+			typename std::make_unsigned<T>::type value;
+			memcpy(&value, data, sizeof(T));
+			if constexpr (sizeof(T) == 2)
+				value = (endian == LittleEndian) ? ToLE16(value) : ToBE16(value);
+			else if constexpr (sizeof(T) == 4)
+				value = (endian == LittleEndian) ? ToLE32(value) : ToBE32(value);
+			else if constexpr (sizeof(T) == 8)
+				value = (endian == LittleEndian) ? ToLE64(value) : ToBE64(value);
+			return (T)value;
+		}
+
+	  public:
+		/*! Create a BufferedBinaryReader instance given a BinaryView and endianness.
+
+			\param data BinaryView to read from
+			\param endian Byte order to read with. One of LittleEndian, BigEndian
+			\param windowSize Number of bytes fetched from the view at a time
+		*/
+		BufferedBinaryReader(BinaryView* data, BNEndianness endian = LittleEndian, size_t windowSize = 0x1000);
+
+		BNEndianness GetEndianness() const { return m_endian; }
+		void SetEndianness(BNEndianness endian) { m_endian = endian; }
+
+		uint64_t GetOffset() const { return m_offset; }
+		void Seek(uint64_t offset) { m_offset = offset; }
+		void SeekRelative(int64_t offset) { m_offset += offset; }
+		bool IsEndOfFile() const;
+
+		/*! Discard the cached window so that the next read fetches fresh data from the view */
+		void Invalidate() { m_windowLength = 0; }
+
+		/*! Try reading \c len bytes from the current cursor position
+
+			\param dest Address to write the read bytes to
+			\param len Number of bytes to read
+			\return Whether the read succeeded
+		*/
+		bool TryRead(void* dest, size_t len);
+
+		/*! Read \c len bytes from the current cursor position
+
+			\throws ReadException
+			\param dest Address to write the read bytes to
+			\param len Number of bytes to read
+		*/
+		void Read(void* dest, size_t len)
+		{
+			if (!TryRead(dest, len))
+				throw ReadException();
+		}
+
+		/*! Try reading an integer with the given byte order
+
+			\param result Reference to write the value to
+			\param endian Byte order of the value
+			\return Whether the read succeeded
+		*/
+		template <typename T>
+		bool TryReadInteger(T& result, BNEndianness endian)
+		{
+			if (IsBuffered(m_offset, sizeof(T)))
+			{
+				result = DecodeInteger<T>(&m_window[m_offset - m_windowStart], endian);
+				m_offset += sizeof(T);
+				return true;
+			}
+
+			uint8_t data[sizeof(T)];
+			if (!TryRead(data, sizeof(T)))
+				return false;
+			result = DecodeInteger<T>(data, endian);
+			return true;
+		}
+
+		template <typename T>
+		bool TryReadInteger(T& result)
+		{
+			return TryReadInteger(result, m_endian);
+		}
+
+		/*! Read an integer with the reader's byte order
+
+			\throws ReadException
+			\return The read value
+		*/
+		template <typename T>
+		T ReadInteger()
+		{
+			T result;
+			if (!TryReadInteger(result, m_endian))
+				throw ReadException();
+			return result;
+		}
+
+		uint8_t Read8() { return ReadInteger<uint8_t>(); }
+		uint16_t Read16() { return ReadInteger<uint16_t>(); }
+		uint32_t Read32() { return ReadInteger<uint32_t>(); }
+		uint64_t Read64() { return ReadInteger<uint64_t>(); }
+		bool TryRead8(uint8_t& result) { return TryReadInteger(result); }
+		bool TryRead16(uint16_t& result) { return TryReadInteger(result); }
+		bool TryRead32(uint32_t& result) { return TryReadInteger(result); }
+		bool TryRead64(uint64_t& result) { return TryReadInteger(result); }
+
+		/*! Try reading a pointer (size of BinaryView::GetAddressSize())
+
+			\param result Reference to a uint64_t to write to
+			\return Whether the read succeeded.
+		*/
+		bool TryReadPointer(uint64_t& result);
+
+		/*! Read a pointer (size of BinaryView::GetAddressSize())
+
+			\throws ReadException
+			\return The read value
+		*/
+		uint64_t ReadPointer()
+		{
+			uint64_t result;
+			if (!TryReadPointer(result))
+				throw ReadException();
+			return result;
+		}
+
+		/*! Try reading \c count consecutive values. Integers are converted from the reader's byte order, other
+			types are copied as they are stored.
+
+			\param result Vector to store the values in, resized to \c count
+			\param count Number of values to read
+			\return Whether the read succeeded
+		*/
+		template <typename T>
+		bool TryReadArray(std::vector<T>& result, size_t count)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "TryReadArray requires a trivially copyable type");
+			if (count > SIZE_MAX / sizeof(T))
+				return false;
+			result.resize(count);
+			if (!TryRead(result.data(), count * sizeof(T)))
+				return false;
+			if constexpr (std::is_integral<T>::value && (sizeof(T) > 1))
+			{
+				for (auto& i : result)
+					i = DecodeInteger<T>((const uint8_t*)&i, m_endian);
+			}
+			return true;
+		}
+
+		/*! Read \c count consecutive values. Integers are converted from the reader's byte order, other types are
+			copied as they are stored.
+
+			\throws ReadException
+			\param count Number of values to read
+			\return The values that were read
+		*/
+		template <typename T>
+		std::vector<T> ReadArray(size_t count)
+		{
+			std::vector<T> result;
+			if (!TryReadArray(result, count))
+				throw ReadException();
+			return result;
+		}
+
+		/*! Try reading a structure exactly as it is stored. No byte order conversion is performed.
+
+			\param result Reference to the structure to write to
+			\return Whether the read succeeded
+		*/
+		template <typename T>
+		bool TryReadStruct(T& result)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "TryReadStruct requires a trivially copyable type");
+			return TryRead(&result, sizeof(T));
+		}
+
+		/*! Read a structure exactly as it is stored. No byte order conversion is performed.
+
+			\throws ReadException
+			\return The structure that was read
+		*/
+		template <typename T>
+		T ReadStruct()
+		{
+			T result;
+			if (!TryReadStruct(result))
+				throw ReadException();
+			return result;
+		}
+	};
+
 	/*! Raised whenever a write is performed out of bounds.
 
 		\ingroup binaryview
@@ -6433,6 +7319,89 @@ namespace BinaryNinja {
 		void SeekRelative(int64_t offset);
 	};
 
+	/*! BatchedBinaryWriter collects writes locally and applies them to a BinaryView in one step.
+
+		Pending writes are kept as a sorted set of extents, with overlapping and adjacent writes merged and later
+		writes taking precedence. Commit writes each extent with a single call inside one undo action, so data
+		written notifications are posted once per merged range. Writes that have not been committed when the
+		writer is destroyed are discarded.
+
+		\ingroup binaryview
+	*/
+	class BatchedBinaryWriter
+	{
+		Ref<BinaryView> m_view;
+		BNEndianness m_endian;
+		uint64_t m_offset;
+		std::map<uint64_t, std::vector<uint8_t>> m_extents;
+
+		void AddExtent(uint64_t offset, const uint8_t* data, size_t len);
+
+	  public:
+		/*! Create a BatchedBinaryWriter instance given a BinaryView and endianness.
+
+			\param data BinaryView to write to
+			\param endian Byte order to write with. One of LittleEndian, BigEndian
+		*/
+		BatchedBinaryWriter(BinaryView* data, BNEndianness endian = LittleEndian);
+
+		BNEndianness GetEndianness() const { return m_endian; }
+		void SetEndianness(BNEndianness endian) { m_endian = endian; }
+
+		uint64_t GetOffset() const { return m_offset; }
+		void Seek(uint64_t offset) { m_offset = offset; }
+		void SeekRelative(int64_t offset) { m_offset += offset; }
+
+		/*! Queue a write of \c len bytes at the current cursor position and advance the cursor
+
+			\param src Address to read the bytes from
+			\param len Amount of bytes to write
+		*/
+		void Write(const void* src, size_t len);
+		void Write(const DataBuffer& buf) { Write(buf.GetData(), buf.GetLength()); }
+		void Write(const std::string& str) { Write(str.c_str(), str.size()); }
+
+		/*! Queue a write of an integer with the given byte order
+
+			\param val Value to write
+			\param endian Byte order to write the value with
+		*/
+		template <typename T>
+		void WriteInteger(T val, BNEndianness endian)
+		{
+			static_assert(std::is_integral<T>::value, "WriteInteger requires an integer type");
+			typename std::make_unsigned<T>::type value = val;
+			if constexpr (sizeof(T) == 2)
+				value = (endian == LittleEndian) ? ToLE16(value) : ToBE16(value);
+			else if constexpr (sizeof(T) == 4)
+				value = (endian == LittleEndian) ? ToLE32(value) : ToBE32(value);
+			else if constexpr (sizeof(T) == 8)
+				value = (endian == LittleEndian) ? ToLE64(value) : ToBE64(value);
+			Write(&value, sizeof(T));
+		}
+
+		void Write8(uint8_t val) { WriteInteger(val, m_endian); }
+		void Write16(uint16_t val) { WriteInteger(val, m_endian); }
+		void Write32(uint32_t val) { WriteInteger(val, m_endian); }
+		void Write64(uint64_t val) { WriteInteger(val, m_endian); }
+
+		/*! Whether there are writes waiting to be committed */
+		bool HasPendingWrites() const { return !m_extents.empty(); }
+
+		/*! Get the number of merged ranges waiting to be committed */
+		size_t GetPendingExtentCount() const { return m_extents.size(); }
+
+		/*! Apply all pending writes to the view as a single undo action. If any range cannot be written, the
+			changes made by this commit are reverted and the pending writes are kept.
+
+			\return Whether all pending writes were applied
+		*/
+		bool Commit();
+
+		/*! Drop all pending writes without applying them */
+		void Discard() { m_extents.clear(); }
+	};
+
 	/*!
 		\ingroup transform
 	*/
@@ -6558,10 +7527,16 @@ namespace BinaryNinja {
 	class Architecture : public StaticCoreRefCountObject<BNArchitecture>
 	{
 	  protected:
+		// Register, flag and intrinsic tables, built once per core architecture on first use
+		struct Metadata;
+		std::atomic<const Metadata*> m_metadata {nullptr};
+
 		std::string m_nameForRegister;
 
 		Architecture(BNArchitecture* arch);
 
+		const Metadata* GetMetadata();
+
 		static void InitCallback(void* ctxt, BNArchitecture* obj);
 		static BNEndianness GetEndiannessCallback(void* ctxt);
 		static size_t GetAddressSizeCallback(void* ctxt);
@@ -6726,6 +7701,9 @@ namespace BinaryNinja {
 
 		/*! Retrieves a list of InstructionTextTokens
 
+			\note Architecture subclasses should implement either this method or the InstructionTextTokenBuilder
+			      overload. The default implementation of each calls the other.
+
 			\param[in] data pointer to the instruction data to retrieve text for
 			\param[in] addr address of the instruction data to retrieve text for
 			\param[out] len will be written to with the length of the instruction data which was translated
@@ -6733,7 +7711,20 @@ namespace BinaryNinja {
 			\return Whether instruction info was successfully retrieved.
 		*/
 		virtual bool GetInstructionText(
-		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) = 0;
+		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result);
+
+		/*! Retrieves the InstructionTextTokens of an instruction into a reusable builder
+
+			This overload is used when the core requests instruction text, and avoids a string allocation per token.
+
+			\param[in] data pointer to the instruction data to retrieve text for
+			\param[in] addr address of the instruction data to retrieve text for
+			\param[out] len will be written to with the length of the instruction data which was translated
+			\param[out] result Empty builder to add the tokens to
+			\return Whether instruction info was successfully retrieved.
+		*/
+		virtual bool GetInstructionText(
+		    const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenBuilder& result);
 
 		/*! Translates an instruction at addr and appends it onto the LowLevelILFunction& il.
 
@@ -7143,6 +8134,7 @@ namespace BinaryNinja {
 		virtual Ref<Architecture> GetAssociatedArchitectureByAddress(uint64_t& addr) override;
 		virtual bool GetInstructionInfo(
 		    const uint8_t* data, uint64_t addr, size_t maxLen, InstructionInfo& result) override;
+		using Architecture::GetInstructionText;
 		virtual bool GetInstructionText(
 		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) override;
 		virtual bool GetInstructionLowLevelIL(
@@ -7227,6 +8219,7 @@ namespace BinaryNinja {
 		virtual Ref<Architecture> GetAssociatedArchitectureByAddress(uint64_t& addr) override;
 		virtual bool GetInstructionInfo(
 		    const uint8_t* data, uint64_t addr, size_t maxLen, InstructionInfo& result) override;
+		using Architecture::GetInstructionText;
 		virtual bool GetInstructionText(
 		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) override;
 		virtual bool GetInstructionLowLevelIL(
@@ -7270,34 +8263,227 @@ namespace BinaryNinja {
 		virtual std::vector<NameAndType> GetIntrinsicInputs(uint32_t intrinsic) override;
 		virtual std::vector<Confidence<Ref<Type>>> GetIntrinsicOutputs(uint32_t intrinsic) override;
 
-		virtual bool CanAssemble() override;
-		virtual bool Assemble(const std::string& code, uint64_t addr, DataBuffer& result, std::string& errors) override;
+		virtual bool CanAssemble() override;
+		virtual bool Assemble(const std::string& code, uint64_t addr, DataBuffer& result, std::string& errors) override;
+
+		virtual bool IsNeverBranchPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool IsAlwaysBranchPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool IsInvertBranchPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool IsSkipAndReturnZeroPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool IsSkipAndReturnValuePatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
+
+		virtual bool ConvertToNop(uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool AlwaysBranch(uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool InvertBranch(uint8_t* data, uint64_t addr, size_t len) override;
+		virtual bool SkipAndReturnValue(uint8_t* data, uint64_t addr, size_t len, uint64_t value) override;
+	};
+
+	/*!
+
+		\ingroup architectures
+	*/
+	class ArchitectureHook : public CoreArchitecture
+	{
+	  protected:
+		Ref<Architecture> m_base;
+
+		virtual void Register(BNCustomArchitecture* callbacks) override;
+
+	  public:
+		ArchitectureHook(Architecture* base);
+	};
+
+	/*! CachingArchitecture is a base class for architectures where decoding an instruction is expensive.
+
+		The core requests the info, text and IL of an instruction separately. A CachingArchitecture decodes
+		the instruction once with DecodeInstruction and passes the decoded instruction to GetDecodedInstructionInfo,
+		GetDecodedInstructionText and GetDecodedInstructionLowLevelIL.
+
+		Decoded instructions are kept in a bounded cache that is sharded by address. A cached decode is only used
+		when the instruction bytes match exactly, so patched or differently mapped code is decoded again.
+
+		\code{.cpp}
+		struct DspInstruction
+		{
+			uint32_t opcode;
+			uint32_t operands[4];
+		};
+
+		class DspArchitecture : public CachingArchitecture<DspInstruction>
+		{
+			bool DecodeInstruction(const uint8_t* data, uint64_t addr, size_t& len, DspInstruction& result) override;
+			bool GetDecodedInstructionInfo(
+				const DspInstruction& instr, uint64_t addr, InstructionInfo& result) override;
+			...
+		};
+		\endcode
+
+		\tparam TInstruction Copyable type holding a decoded instruction
+		@threadsafe
+		\ingroup architectures
+	*/
+	template <typename TInstruction>
+	class CachingArchitecture : public Architecture
+	{
+		struct CacheEntry
+		{
+			bool valid = false;
+			uint64_t addr = 0;
+			size_t length = 0;
+			uint8_t bytes[BN_MAX_INSTRUCTION_LENGTH];
+			TInstruction instr;
+		};
+
+		struct CacheShard
+		{
+			std::mutex mutex;
+			std::vector<CacheEntry> entries;  // Direct mapped, allocated on first use
+		};
+
+		static constexpr size_t ShardCount = 16;
+
+		CacheShard m_shards[ShardCount];
+		size_t m_entriesPerShard;
+
+		static uint64_t HashAddress(uint64_t addr)
+		{
+			addr ^= addr >> 33;
+			addr *= 0xff51afd7ed558ccdULL;
+			addr ^= addr >> 33;
+			return addr;
+		}
+
+		bool GetCachedInstruction(const uint8_t* data, uint64_t addr, size_t maxLen, TInstruction& result, size_t& len)
+		{
+			uint64_t hash = HashAddress(addr);
+			CacheShard& shard = m_shards[hash % ShardCount];
+			size_t index = (size_t)((hash / ShardCount) % m_entriesPerShard);
+			{
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				if (!shard.entries.empty())
+				{
+					CacheEntry& entry = shard.entries[index];
+					if (entry.valid && (entry.addr == addr) && (entry.length <= maxLen)
+					    && (memcmp(entry.bytes, data, entry.length) == 0))
+					{
+						result = entry.instr;
+						len = entry.length;
+						return true;
+					}
+				}
+			}
+
+			len = maxLen;
+			if (!DecodeInstruction(data, addr, len, result) || (len == 0) || (len > maxLen))
+				return false;
+			if (len > BN_MAX_INSTRUCTION_LENGTH)
+				return true;
+
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			if (shard.entries.empty())
+				shard.entries.resize(m_entriesPerShard);
+			CacheEntry& entry = shard.entries[index];
+			entry.valid = true;
+			entry.addr = addr;
+			entry.length = len;
+			memcpy(entry.bytes, data, len);
+			entry.instr = result;
+			return true;
+		}
+
+	  protected:
+		/*! Decodes the instruction at addr
+
+			\param[in] data pointer to the instruction data to decode
+			\param[in] addr address of the instruction data to decode
+			\param[in,out] len length of the available data, will be written to with the length of the instruction
+			\param[out] result Decoded instruction
+			\return Whether the instruction was successfully decoded
+		*/
+		virtual bool DecodeInstruction(const uint8_t* data, uint64_t addr, size_t& len, TInstruction& result) = 0;
+
+		/*! Retrieves the instruction info of a decoded instruction
 
-		virtual bool IsNeverBranchPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool IsAlwaysBranchPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool IsInvertBranchPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool IsSkipAndReturnZeroPatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool IsSkipAndReturnValuePatchAvailable(const uint8_t* data, uint64_t addr, size_t len) override;
+			\param[in] instr Decoded instruction
+			\param[in] addr address of the instruction
+			\param[out] result Retrieved instruction info, its length is set to the decoded length
+			\return Whether instruction info was successfully retrieved.
+		*/
+		virtual bool GetDecodedInstructionInfo(const TInstruction& instr, uint64_t addr, InstructionInfo& result) = 0;
 
-		virtual bool ConvertToNop(uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool AlwaysBranch(uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool InvertBranch(uint8_t* data, uint64_t addr, size_t len) override;
-		virtual bool SkipAndReturnValue(uint8_t* data, uint64_t addr, size_t len, uint64_t value) override;
-	};
+		/*! Retrieves the InstructionTextTokens of a decoded instruction
 
-	/*!
+			\param[in] instr Decoded instruction
+			\param[in] addr address of the instruction
+			\param[in,out] len length of the decoded instruction, may be changed to the length that was translated
+			\param[out] result Instruction text tokens
+			\return Whether instruction text was successfully retrieved.
+		*/
+		virtual bool GetDecodedInstructionText(
+		    const TInstruction& instr, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) = 0;
 
-		\ingroup architectures
-	*/
-	class ArchitectureHook : public CoreArchitecture
-	{
-	  protected:
-		Ref<Architecture> m_base;
+		/*! Translates a decoded instruction and appends it onto the LowLevelILFunction& il.
 
-		virtual void Register(BNCustomArchitecture* callbacks) override;
+			\param[in] instr Decoded instruction
+			\param[in] addr address of the instruction
+			\param[in,out] len length of the decoded instruction, may be changed to the length that was translated
+			\param[in,out] il the LowLevelILFunction to appended to.
+		*/
+		virtual bool GetDecodedInstructionLowLevelIL(
+		    const TInstruction& instr, uint64_t addr, size_t& len, LowLevelILFunction& il)
+		{
+			return Architecture::GetInstructionLowLevelIL(nullptr, addr, len, il);
+		}
 
 	  public:
-		ArchitectureHook(Architecture* base);
+		/*!
+			\param name Name of the architecture
+			\param cacheSize Maximum number of decoded instructions to keep
+		*/
+		CachingArchitecture(const std::string& name, size_t cacheSize = 65536) :
+		    Architecture(name), m_entriesPerShard(std::max<size_t>(cacheSize / ShardCount, 1))
+		{}
+
+		/*! Drop all cached instructions */
+		void ClearInstructionCache()
+		{
+			for (auto& shard : m_shards)
+			{
+				std::vector<CacheEntry> entries;
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				shard.entries.swap(entries);
+			}
+		}
+
+		virtual bool GetInstructionInfo(
+		    const uint8_t* data, uint64_t addr, size_t maxLen, InstructionInfo& result) override
+		{
+			TInstruction instr;
+			size_t len;
+			if (!GetCachedInstruction(data, addr, maxLen, instr, len))
+				return false;
+			result.length = len;
+			return GetDecodedInstructionInfo(instr, addr, result);
+		}
+
+		using Architecture::GetInstructionText;
+		virtual bool GetInstructionText(
+		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) override
+		{
+			TInstruction instr;
+			if (!GetCachedInstruction(data, addr, len, instr, len))
+				return false;
+			return GetDecodedInstructionText(instr, addr, len, result);
+		}
+
+		virtual bool GetInstructionLowLevelIL(
+		    const uint8_t* data, uint64_t addr, size_t& len, LowLevelILFunction& il) override
+		{
+			TInstruction instr;
+			if (!GetCachedInstruction(data, addr, len, instr, len))
+				return Architecture::GetInstructionLowLevelIL(data, addr, len, il);
+			return GetDecodedInstructionLowLevelIL(instr, addr, len, il);
+		}
 	};
 
 	class Structure;
@@ -9164,6 +10350,99 @@ namespace BinaryNinja {
 	class Component;
 	struct SSAVariable;
 
+	/*! Dominator or post dominator tree of a set of basic blocks, stored in flat arrays indexed by block index.
+
+		The tree is a snapshot taken when it is built, using the immediate dominators computed by the core. Dominance
+		queries are O(1) through DFS intervals over the tree, and iterated dominance frontiers are computed with
+		bitsets, so no BasicBlock objects are created while querying.
+
+		\ingroup basicblocks
+	*/
+	class DominatorTree
+	{
+	  public:
+		static constexpr size_t NoBlock = (size_t)-1;
+
+		/*! Contiguous list of block indices */
+		struct BlockIndexRange
+		{
+			const size_t* first;
+			const size_t* last;
+
+			const size_t* begin() const { return first; }
+			const size_t* end() const { return last; }
+			size_t size() const { return last - first; }
+			bool empty() const { return first == last; }
+			size_t operator[](size_t i) const { return first[i]; }
+		};
+
+	  private:
+		bool m_post = false;
+		std::vector<Ref<BasicBlock>> m_blocks;
+		std::vector<size_t> m_idom;
+		std::vector<size_t> m_depth;
+		std::vector<size_t> m_enter;
+		std::vector<size_t> m_exit;
+		std::vector<size_t> m_childOffsets;
+		std::vector<size_t> m_children;
+		std::vector<size_t> m_frontierOffsets;
+		std::vector<size_t> m_frontiers;
+
+		bool IsValidIndex(size_t index) const { return index < m_blocks.size() && m_blocks[index]; }
+
+	  public:
+		DominatorTree() = default;
+
+		/*! Build the tree for a set of blocks, such as the blocks of a function or of an IL function
+
+			\param blocks Every block of the graph
+			\param post Whether to build the post dominator tree
+		*/
+		DominatorTree(const std::vector<Ref<BasicBlock>>& blocks, bool post = false);
+
+		bool IsPostDominatorTree() const { return m_post; }
+
+		/*! One more than the highest block index in the tree */
+		size_t GetBlockCount() const { return m_blocks.size(); }
+		Ref<BasicBlock> GetBlock(size_t index) const { return m_blocks[index]; }
+
+		/*! Index of the immediate (post) dominator of a block, or NoBlock for tree roots */
+		size_t GetImmediateDominator(size_t index) const { return m_idom[index]; }
+
+		/*! Distance from the root of the tree containing the block */
+		size_t GetDepth(size_t index) const { return m_depth[index]; }
+
+		/*! Whether block \c a dominates block \c b. Every block dominates itself. */
+		bool Dominates(size_t a, size_t b) const
+		{
+			if (!IsValidIndex(a) || !IsValidIndex(b))
+				return false;
+			return m_enter[a] <= m_enter[b] && m_exit[b] <= m_exit[a];
+		}
+
+		bool StrictlyDominates(size_t a, size_t b) const { return a != b && Dominates(a, b); }
+
+		BlockIndexRange GetChildren(size_t index) const
+		{
+			return {m_children.data() + m_childOffsets[index], m_children.data() + m_childOffsets[index + 1]};
+		}
+
+		BlockIndexRange GetDominanceFrontier(size_t index) const
+		{
+			return {m_frontiers.data() + m_frontierOffsets[index], m_frontiers.data() + m_frontierOffsets[index + 1]};
+		}
+
+		/*! Iterated dominance frontier of a set of blocks, as used for placing SSA phi nodes
+
+			\param blocks Block indices
+			\return Block indices of the iterated frontier, in ascending order
+		*/
+		std::vector<size_t> GetIteratedDominanceFrontier(const std::vector<size_t>& blocks) const;
+
+		/*! Nearest block dominating both \c a and \c b, or NoBlock if they are in different trees */
+		size_t GetCommonDominator(size_t a, size_t b) const;
+	};
+
 	/*!
 		\ingroup function
 	*/
@@ -9171,6 +10450,8 @@ namespace BinaryNinja {
 	{
 		int m_advancedAnalysisRequests;
 
+		friend class BinaryDataNotification;
+
 	  public:
 		Function(BNFunction* func);
 		virtual ~Function();
@@ -9247,6 +10528,13 @@ namespace BinaryNinja {
 		*/
 		std::vector<Ref<BasicBlock>> GetBasicBlocks() const;
 
+		/*! Get the dominator tree of the function's basic blocks
+
+			\param post Whether to get the post dominator tree
+			\return Dominator tree indexed by basic block index
+		*/
+		DominatorTree GetDominatorTree(bool post = false) const;
+
 		/*! Get the basic block an address is located in
 
 			\param arch Architecture for the basic block
@@ -9782,6 +11070,124 @@ namespace BinaryNinja {
 		void SetFunction(Function* func);
 	};
 
+	/*! Type-erased storage behind AnalysisDataSlot
+
+		Entries live in a process-wide table sharded by owner, so activities running on different functions do not
+		contend on a single lock. Entries are released when their BinaryView or Function is destroyed.
+
+		\ingroup workflow
+	*/
+	class AnalysisDataSlotBase
+	{
+		size_t m_id;
+		bool m_invalidateOnReanalysis;
+
+	  protected:
+		AnalysisDataSlotBase(bool invalidateOnReanalysis);
+		~AnalysisDataSlotBase();
+
+		std::shared_ptr<void> GetEntry(void* owner) const;
+		std::shared_ptr<void> GetOrCreateEntry(
+		    BNBinaryView* view, BNFunction* func, const std::function<std::shared_ptr<void>()>& create);
+		void SetEntry(BNBinaryView* view, BNFunction* func, std::shared_ptr<void> value);
+		void RemoveEntry(void* owner);
+
+	  public:
+		AnalysisDataSlotBase(const AnalysisDataSlotBase&) = delete;
+		AnalysisDataSlotBase& operator=(const AnalysisDataSlotBase&) = delete;
+
+		/*! Whether function entries of this slot are dropped when reanalysis of the function is requested */
+		bool IsInvalidatedOnReanalysis() const { return m_invalidateOnReanalysis; }
+
+		/*! Release the entries of this slot for all views and functions */
+		void Clear();
+	};
+
+	/*! AnalysisDataSlot attaches typed data to a BinaryView or Function for use by workflow activities.
+
+		A slot is usually a static object owned by the plugin. Values are held by std::shared_ptr, so a value
+		returned from Get stays valid after its owner is destroyed or the entry is replaced. The slot only
+		synchronizes access to the entry itself; a value that is modified from multiple threads must provide its own
+		locking.
+
+		When \c invalidateOnReanalysis is set, function entries are dropped whenever reanalysis of the function is
+		requested. View entries are unaffected.
+
+		\code{.cpp}
+		struct CallSites
+		{
+			std::mutex mutex;
+			std::set<uint64_t> addresses;
+		};
+		static AnalysisDataSlot<CallSites> g_callSites;
+
+		void MyActivity(Ref<AnalysisContext> analysisContext)
+		{
+			if (auto callSites = g_callSites.Get(analysisContext))
+				...
+		}
+		\endcode
+
+		\tparam T Type of the stored value
+		@threadsafe
+		\ingroup workflow
+	*/
+	template <typename T>
+	class AnalysisDataSlot : public AnalysisDataSlotBase
+	{
+	  public:
+		AnalysisDataSlot(bool invalidateOnReanalysis = false) : AnalysisDataSlotBase(invalidateOnReanalysis) {}
+
+		/*! Get the value stored for a view or function
+
+			\return The stored value, or nullptr if none is set
+		*/
+		std::shared_ptr<T> Get(BinaryView* view) const
+		{
+			return std::static_pointer_cast<T>(GetEntry(view->GetObject()));
+		}
+		std::shared_ptr<T> Get(Function* func) const
+		{
+			return std::static_pointer_cast<T>(GetEntry(func->GetObject()));
+		}
+		std::shared_ptr<T> Get(AnalysisContext* analysisContext) const
+		{
+			Ref<Function> func = analysisContext->GetFunction();
+			return func ? Get(func.GetPtr()) : nullptr;
+		}
+
+		/*! Get the value stored for a view or function, storing a default constructed value if none is set
+
+			\return The stored value
+		*/
+		std::shared_ptr<T> GetOrCreate(BinaryView* view)
+		{
+			return std::static_pointer_cast<T>(
+			    GetOrCreateEntry(view->GetObject(), nullptr, []() { return std::make_shared<T>(); }));
+		}
+		std::shared_ptr<T> GetOrCreate(Function* func)
+		{
+			return std::static_pointer_cast<T>(
+			    GetOrCreateEntry(nullptr, func->GetObject(), []() { return std::make_shared<T>(); }));
+		}
+		std::shared_ptr<T> GetOrCreate(AnalysisContext* analysisContext)
+		{
+			Ref<Function> func = analysisContext->GetFunction();
+			return func ? GetOrCreate(func.GetPtr()) : nullptr;
+		}
+
+		/*! Replace the value stored for a view or function
+
+			\param value New value, or nullptr to remove the entry
+		*/
+		void Set(BinaryView* view, std::shared_ptr<T> value) { SetEntry(view->GetObject(), nullptr, std::move(value)); }
+		void Set(Function* func, std::shared_ptr<T> value) { SetEntry(nullptr, func->GetObject(), std::move(value)); }
+
+		/*! Remove the value stored for a view or function */
+		void Remove(BinaryView* view) { RemoveEntry(view->GetObject()); }
+		void Remove(Function* func) { RemoveEntry(func->GetObject()); }
+	};
+
 	class FlowGraphNode;
 
 	/*!
@@ -10151,12 +11557,108 @@ namespace BinaryNinja {
 		{}
 	};
 
+	/*! Order in which the IL \c WalkExprs visitors invoke their callback
+	*/
+	enum ILVisitOrder
+	{
+		// An expression is visited before its operands
+		PreOrderILVisit,
+		// An expression is visited after all of its operands
+		PostOrderILVisit
+	};
+
+	/*! Result of an IL \c WalkExprs callback
+	*/
+	enum ILVisitAction
+	{
+		ContinueILVisit,
+		// Do not descend into the operands of this expression. Only meaningful for pre-order walks.
+		SkipChildrenILVisit,
+		StopILVisit
+	};
+
+	/*! Scratch stack entry used by the IL \c WalkExprs visitors. Callers that walk many expressions should keep one
+		vector of these alive and pass it to every walk so that its storage is reused.
+	*/
+	template <typename T>
+	struct ILExprVisitEntry
+	{
+		T instr;
+		size_t exprIndex;
+		bool expanded;
+	};
+
+	/*! Invoke an IL visitor callback. Callbacks may return \c ILVisitAction, \c bool (\c false skips the operands of
+		the expression, as with \c VisitExprs) or nothing.
+	*/
+	template <typename F, typename T>
+	ILVisitAction InvokeILExprVisitor(F& func, size_t exprIndex, const T& instr)
+	{
+		typedef decltype(func(exprIndex, instr)) ResultType;
+		if constexpr (std::is_void_v<ResultType>)
+		{
+			func(exprIndex, instr);
+			return ContinueILVisit;
+		}
+		else if constexpr (std::is_same_v<ResultType, bool>)
+		{
+			return func(exprIndex, instr) ? ContinueILVisit : SkipChildrenILVisit;
+		}
+		else
+		{
+			return func(exprIndex, instr);
+		}
+	}
+
+	/*! Shared implementation of the IL \c WalkExprs visitors. \c pushChildren is called to append the operand
+		expressions of an expression to \c stack in operand order.
+
+		\return false if the walk was stopped by the callback
+	*/
+	template <typename T, typename F, typename PushChildren>
+	bool WalkILExprs(const T& root, size_t rootIndex, F& func, std::vector<ILExprVisitEntry<T>>& stack,
+	    ILVisitOrder order, const PushChildren& pushChildren)
+	{
+		// Walks may be nested on the same scratch stack, so only ever touch entries above the starting depth
+		const size_t base = stack.size();
+		stack.push_back({root, rootIndex, false});
+		while (stack.size() > base)
+		{
+			ILExprVisitEntry<T> entry = stack.back();
+			stack.pop_back();
+
+			if ((order == PreOrderILVisit) || entry.expanded)
+			{
+				ILVisitAction action = InvokeILExprVisitor(func, entry.exprIndex, entry.instr);
+				if (action == StopILVisit)
+				{
+					stack.resize(base);
+					return false;
+				}
+				if ((action == SkipChildrenILVisit) || entry.expanded)
+					continue;
+			}
+			else
+			{
+				entry.expanded = true;
+				stack.push_back(entry);
+			}
+
+			// Children are appended in operand order, reverse them so they are popped in operand order
+			size_t childStart = stack.size();
+			pushChildren(entry.instr, stack);
+			std::reverse(stack.begin() + childStart, stack.end());
+		}
+		return true;
+	}
+
 	struct LowLevelILInstruction;
 	struct RegisterOrFlag;
 	struct SSARegister;
 	struct SSARegisterStack;
 	struct SSAFlag;
 	struct SSARegisterOrFlag;
+	class LowLevelILFunctionSnapshot;
 
 	/*!
 		\ingroup lowlevelil
@@ -11444,6 +12946,12 @@ namespace BinaryNinja {
 		size_t GetInstructionCount() const;
 		size_t GetExprCount() const;
 
+		/*! Copy every expression of this function into a flat, structure-of-arrays snapshot
+
+			\return A snapshot that can be walked without further calls into the core
+		*/
+		LowLevelILFunctionSnapshot Snapshot();
+
 		void UpdateInstructionOperand(size_t i, size_t operandIndex, ExprId value);
 		void ReplaceExpr(size_t expr, size_t newExpr);
 		void SetExprAttributes(size_t expr, uint32_t attributes);
@@ -11547,6 +13055,132 @@ namespace BinaryNinja {
 		Ref<FlowGraph> CreateFunctionGraph(DisassemblySettings* settings = nullptr);
 	};
 
+	/*! Lightweight, non-refcounted view of an expression in a LowLevelILFunctionSnapshot. Views are only valid
+		for the lifetime of the snapshot they were obtained from.
+
+		\ingroup lowlevelil
+	*/
+	class LowLevelILSnapshotExpr
+	{
+		const LowLevelILFunctionSnapshot* m_snapshot;
+		size_t m_exprIndex;
+
+	  public:
+		LowLevelILSnapshotExpr(const LowLevelILFunctionSnapshot* snapshot, size_t exprIndex) :
+		    m_snapshot(snapshot), m_exprIndex(exprIndex)
+		{}
+
+		const LowLevelILFunctionSnapshot* GetSnapshot() const { return m_snapshot; }
+		size_t GetExprIndex() const { return m_exprIndex; }
+
+		inline BNLowLevelILOperation GetOperation() const;
+		inline uint32_t GetAttributes() const;
+		inline size_t GetSize() const;
+		inline uint32_t GetFlags() const;
+		inline uint32_t GetSourceOperand() const;
+		inline uint64_t GetAddress() const;
+		inline uint64_t GetRawOperand(size_t operand) const;
+		inline LowLevelILSnapshotExpr GetRawOperandAsExpr(size_t operand) const;
+
+		BNLowLevelILInstruction GetRawExpr() const;
+
+		/*! Materialize a full LowLevelILInstruction for this expression. This goes back to the core to
+			look up the owning instruction index, so avoid it in hot loops.
+		*/
+		LowLevelILInstruction ToInstruction() const;
+	};
+
+	/*! Structure-of-arrays copy of every expression in a LowLevelILFunction, taken in a single pass.
+
+		Reading from a snapshot does not call into the core or touch any reference counts, which makes it suitable
+		for batch passes that walk every instruction of a function. A snapshot does not observe modifications made
+		to the function after it was taken.
+
+		\ingroup lowlevelil
+	*/
+	class LowLevelILFunctionSnapshot
+	{
+		friend class LowLevelILSnapshotExpr;
+
+		Ref<LowLevelILFunction> m_function;
+		std::vector<BNLowLevelILOperation> m_operations;
+		std::vector<uint32_t> m_attributes;
+		std::vector<size_t> m_sizes;
+		std::vector<uint32_t> m_flags;
+		std::vector<uint32_t> m_sourceOperands;
+		std::vector<uint64_t> m_operands;
+		std::vector<uint64_t> m_addresses;
+		std::vector<size_t> m_instructionExprs;
+
+	  public:
+		static constexpr size_t OperandsPerExpr = 4;
+
+		LowLevelILFunctionSnapshot(LowLevelILFunction* func);
+
+		LowLevelILFunction* GetFunction() const { return m_function; }
+		size_t GetExprCount() const { return m_operations.size(); }
+		size_t GetInstructionCount() const { return m_instructionExprs.size(); }
+		size_t GetIndexForInstruction(size_t i) const { return m_instructionExprs[i]; }
+
+		LowLevelILSnapshotExpr GetExpr(size_t i) const { return LowLevelILSnapshotExpr(this, i); }
+		LowLevelILSnapshotExpr GetInstruction(size_t i) const
+		{
+			return LowLevelILSnapshotExpr(this, m_instructionExprs[i]);
+		}
+		LowLevelILSnapshotExpr operator[](size_t i) const { return GetInstruction(i); }
+
+		// Direct access to the underlying columns, indexed by expression index. Operands are stored
+		// OperandsPerExpr consecutive entries per expression.
+		const std::vector<BNLowLevelILOperation>& GetOperations() const { return m_operations; }
+		const std::vector<uint32_t>& GetAttributes() const { return m_attributes; }
+		const std::vector<size_t>& GetSizes() const { return m_sizes; }
+		const std::vector<uint32_t>& GetFlags() const { return m_flags; }
+		const std::vector<uint32_t>& GetSourceOperands() const { return m_sourceOperands; }
+		const std::vector<uint64_t>& GetOperands() const { return m_operands; }
+		const std::vector<uint64_t>& GetAddresses() const { return m_addresses; }
+		const std::vector<size_t>& GetInstructionExprs() const { return m_instructionExprs; }
+	};
+
+	inline BNLowLevelILOperation LowLevelILSnapshotExpr::GetOperation() const
+	{
+		return m_snapshot->m_operations[m_exprIndex];
+	}
+
+	inline uint32_t LowLevelILSnapshotExpr::GetAttributes() const
+	{
+		return m_snapshot->m_attributes[m_exprIndex];
+	}
+
+	inline size_t LowLevelILSnapshotExpr::GetSize() const
+	{
+		return m_snapshot->m_sizes[m_exprIndex];
+	}
+
+	inline uint32_t LowLevelILSnapshotExpr::GetFlags() const
+	{
+		return m_snapshot->m_flags[m_exprIndex];
+	}
+
+	inline uint32_t LowLevelILSnapshotExpr::GetSourceOperand() const
+	{
+		return m_snapshot->m_sourceOperands[m_exprIndex];
+	}
+
+	inline uint64_t LowLevelILSnapshotExpr::GetAddress() const
+	{
+		return m_snapshot->m_addresses[m_exprIndex];
+	}
+
+	inline uint64_t LowLevelILSnapshotExpr::GetRawOperand(size_t operand) const
+	{
+		return m_snapshot->m_operands[(m_exprIndex * LowLevelILFunctionSnapshot::OperandsPerExpr) + operand];
+	}
+
+	inline LowLevelILSnapshotExpr LowLevelILSnapshotExpr::GetRawOperandAsExpr(size_t operand) const
+	{
+		return LowLevelILSnapshotExpr(m_snapshot, (size_t)GetRawOperand(operand));
+	}
+
 	/*!
 		\ingroup mediumlevelil
 	*/
@@ -15107,11 +16741,87 @@ namespace BinaryNinja {
 
 		std::vector<LinearDisassemblyLine> GetLines();
 
+		/*! Append the lines of the current object to \c lines, avoiding a temporary vector
+
+			\param lines Vector to append to
+			\return Number of lines appended
+		*/
+		size_t GetLines(std::vector<LinearDisassemblyLine>& lines);
+
 		Ref<LinearViewCursor> Duplicate();
 
 		static int Compare(LinearViewCursor* a, LinearViewCursor* b);
 	};
 
+	/*! LinearLineStream produces the lines of a linear view in order, rendering ahead of the reader on the worker
+		thread pool.
+
+		The ordering index range is split into segments. Each segment is rendered by its own cursor, and objects
+		are assigned to the segment that contains the start of their ordering index range, so no line is produced
+		twice. At most \c maxSegmentsInFlight segments are rendered or buffered at a time, which bounds memory
+		regardless of the size of the view. If the reader reaches a segment that no worker has started, it renders
+		that segment itself, so a stream can also be consumed from a worker thread.
+
+		\code{.cpp}
+		LinearLineStream stream(LinearViewObject::CreateDisassembly(view, settings));
+		LinearDisassemblyLine line;
+		while (stream.Next(line))
+			WriteLine(out, line);
+		\endcode
+
+		\ingroup linearview
+	*/
+	class LinearLineStream
+	{
+		struct State;
+		std::shared_ptr<State> m_state;
+
+		void ScheduleSegments();
+
+	  public:
+		/*! Stream every line of \c root
+
+			\param root Root object of the linear view
+			\param segmentSize Size of each segment in ordering index units, or 0 for a default
+			\param maxSegmentsInFlight Maximum number of segments rendered ahead, or 0 for twice the worker count
+		*/
+		LinearLineStream(LinearViewObject* root, uint64_t segmentSize = 0, size_t maxSegmentsInFlight = 0);
+
+		/*! Stream the lines of the objects in an address range
+
+			\param root Root object of the linear view
+			\param range Addresses to produce lines for, objects that start before \c range.end are included in full
+			\param segmentSize Size of each segment in ordering index units, or 0 for a default
+			\param maxSegmentsInFlight Maximum number of segments rendered ahead, or 0 for twice the worker count
+		*/
+		LinearLineStream(LinearViewObject* root, const BNAddressRange& range, uint64_t segmentSize = 0,
+		    size_t maxSegmentsInFlight = 0);
+
+		/*! Stops rendering segments that have not started yet */
+		~LinearLineStream();
+
+		LinearLineStream(const LinearLineStream&) = delete;
+		LinearLineStream& operator=(const LinearLineStream&) = delete;
+
+		/*! Move the next line into \c line, waiting for it to be rendered if needed
+
+			\param line Receives the line
+			\return False once every line has been produced
+		*/
+		bool Next(LinearDisassemblyLine& line);
+
+		/*! Move every line of the next rendered segment into \c lines, replacing its contents
+
+			\param lines Receives the lines, may be empty if a segment contains no objects
+			\return False once every line has been produced
+		*/
+		bool NextBatch(std::vector<LinearDisassemblyLine>& lines);
+
+		/*! Ordering index of the end of the last segment handed out, for progress reporting */
+		uint64_t GetPosition() const;
+		uint64_t GetEnd() const;
+	};
+
 	/*!
 
 		\ingroup simplifyname
@@ -518,3 +518,98 @@ string BinaryReader::ReadCString(size_t maxSize)
 	}
 	return result;
 }
+
+
+BufferedBinaryReader::BufferedBinaryReader(BinaryView* data, BNEndianness endian, size_t windowSize) :
+    m_view(data), m_endian(endian), m_addressSize(data->GetAddressSize()), m_offset(data->GetStart()),
+    m_window(windowSize ? windowSize : 1), m_windowStart(0), m_windowLength(0)
+{
+}
+
+
+bool BufferedBinaryReader::IsEndOfFile() const
+{
+	return m_offset >= m_view->GetEnd();
+}
+
+
+bool BufferedBinaryReader::FillWindow(uint64_t offset, size_t len)
+{
+	// Align windows to their size so that reads moving back and forth within a region stay cached
+	uint64_t start = offset - (offset % m_window.size());
+	m_windowStart = start;
+	m_windowLength = BNReadViewData(m_view->GetObject(), m_window.data(), start, m_window.size());
+	if (IsBuffered(offset, len))
+		return true;
+	if (start == offset)
+		return false;
+
+	// The aligned window can stop short at a gap in the view or end before the requested range
+	m_windowStart = offset;
+	m_windowLength = BNReadViewData(m_view->GetObject(), m_window.data(), offset, m_window.size());
+	return IsBuffered(offset, len);
+}
+
+
+bool BufferedBinaryReader::TryReadUnbuffered(void* dest, size_t len)
+{
+	if (BNReadViewData(m_view->GetObject(), dest, m_offset, len) != len)
+		return false;
+	m_offset += len;
+	return true;
+}
+
+
+bool BufferedBinaryReader::TryRead(void* dest, size_t len)
+{
+	if (len > m_window.size())
+		return TryReadUnbuffered(dest, len);
+	if (!IsBuffered(m_offset, len) && !FillWindow(m_offset, len))
+		return false;
+	memcpy(dest, &m_window[m_offset - m_windowStart], len);
+	m_offset += len;
+	return true;
+}
+
+
+bool BufferedBinaryReader::TryReadPointer(uint64_t& result)
+{
+	switch (m_addressSize)
+	{
+		case 1:
+		{
+			uint8_t r;
+			if (!TryReadInteger(r))
+				return false;
+			result = r;
+			break;
+		}
+		case 2:
+		{
+			uint16_t r;
+			if (!TryReadInteger(r))
+				return false;
+			result = r;
+			break;
+		}
+		case 4:
+		{
+			uint32_t r;
+			if (!TryReadInteger(r))
+				return false;
+			result = r;
+			break;
+		}
+		case 8:
+		{
+			if (!TryReadInteger(result))
+				return false;
+			break;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+	return true;
+}
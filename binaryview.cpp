@@ -19,6 +19,7 @@
 // IN THE SOFTWARE.
 
 #include <algorithm>
+#include <condition_variable>
 #include <iterator>
 #include <memory>
 #include "binaryninjaapi.h"
@@ -38,10 +39,172 @@ struct SymbolQueueAddContext
 };
 
 
+// A callback object wraps the core handle passed to the callback without taking a reference of its own, since the
+// core keeps the handle alive until the callback returns. Every Ref taken while the object is borrowed adds a core
+// reference, so an object the callback kept is handed over to those Refs and a new one is used for later callbacks.
+template <typename T>
+class BinaryDataNotification::BorrowedObject
+{
+	static thread_local vector<unique_ptr<T>> m_objects;
+	static thread_local size_t m_depth;
+
+	T* m_obj;
+
+	static bool IsKept(Function* func) { return (func->m_refs != 1) || (func->m_advancedAnalysisRequests != 0); }
+	static bool IsKept(Symbol* sym) { return sym->m_refs != 1; }
+
+	static unique_ptr<T> CreateObject()
+	{
+		// The internal reference keeps the object alive and does not own a core reference
+		unique_ptr<T> obj(new T(nullptr));
+		obj->AddRefForCallback();
+		return obj;
+	}
+
+  public:
+	BorrowedObject(decltype(T::m_object) handle)
+	{
+		if (m_depth == m_objects.size())
+			m_objects.push_back(CreateObject());
+		m_obj = m_objects[m_depth++].get();
+		m_obj->m_object = handle;
+	}
+
+	~BorrowedObject()
+	{
+		m_depth--;
+		if (IsKept(m_obj))
+		{
+			// Dropping the internal reference destroys an object that is only kept for its pending analysis
+			// requests while the handle is still valid
+			m_objects[m_depth].release();
+			m_objects[m_depth] = CreateObject();
+			m_obj->ReleaseForCallback();
+			return;
+		}
+		m_obj->m_object = nullptr;
+	}
+
+	BorrowedObject(const BorrowedObject&) = delete;
+	BorrowedObject& operator=(const BorrowedObject&) = delete;
+
+	operator T*() const { return m_obj; }
+};
+
+template <typename T>
+thread_local vector<unique_ptr<T>> BinaryDataNotification::BorrowedObject<T>::m_objects;
+template <typename T>
+thread_local size_t BinaryDataNotification::BorrowedObject<T>::m_depth = 0;
+
+
+// A view also borrows its file, which the view keeps open
+template <>
+class BinaryDataNotification::BorrowedObject<BinaryView>
+{
+	struct Objects
+	{
+		BinaryView* view = nullptr;
+		FileMetadata* file = nullptr;
+
+		Objects() = default;
+		Objects(const Objects&) = delete;
+		Objects& operator=(const Objects&) = delete;
+		Objects(Objects&& other) : view(other.view), file(other.file) { other.view = nullptr; other.file = nullptr; }
+
+		~Objects()
+		{
+			if (view)
+				view->ReleaseForCallback();
+			if (file)
+				file->ReleaseForCallback();
+		}
+	};
+
+	static thread_local vector<Objects> m_objects;
+	static thread_local size_t m_depth;
+
+	// Nested callbacks can grow m_objects, so entries are looked up by index
+	size_t m_index;
+
+	static FileMetadata* CreateFile()
+	{
+		FileMetadata* file = new FileMetadata(nullptr);
+		file->AddRefForCallback();
+		return file;
+	}
+
+  public:
+	BorrowedObject(BNBinaryView* handle)
+	{
+		if (m_depth == m_objects.size())
+			m_objects.emplace_back();
+		m_index = m_depth++;
+		Objects& objs = m_objects[m_index];
+
+		BNFileMetadata* file = BNGetFileForView(handle);
+		BNFreeFileMetadata(file);
+
+		if (!objs.view)
+		{
+			// The constructor wraps a new file reference, which is replaced by the borrowed file
+			if (!objs.file)
+				objs.file = CreateFile();
+			objs.view = new BinaryView(handle);
+			objs.view->m_file = objs.file;
+			objs.view->AddRefForCallback();
+		}
+		objs.view->m_object = handle;
+		objs.file->m_object = file;
+	}
+
+	~BorrowedObject()
+	{
+		m_depth--;
+		Objects& objs = m_objects[m_index];
+		BinaryView* view = objs.view;
+		FileMetadata* file = objs.file;
+
+		if (view->m_refs != 1)
+		{
+			// The view's own Ref to the file was taken while borrowed and needs a core reference once handed over
+			BNNewFileReference(file->m_object);
+			objs.view = nullptr;
+			objs.file = nullptr;
+			view->ReleaseForCallback();
+			file->ReleaseForCallback();
+			return;
+		}
+
+		if (file->m_refs != 2)
+		{
+			// Only the file was kept. The view's Ref is dropped through a core reference so the count stays balanced.
+			BNNewFileReference(file->m_object);
+			objs.file = CreateFile();
+			view->m_file = objs.file;
+			file->ReleaseForCallback();
+		}
+		else
+		{
+			file->m_object = nullptr;
+		}
+		view->m_object = nullptr;
+	}
+
+	BorrowedObject(const BorrowedObject&) = delete;
+	BorrowedObject& operator=(const BorrowedObject&) = delete;
+
+	operator BinaryView*() const { return m_objects[m_index].view; }
+};
+
+thread_local vector<BinaryDataNotification::BorrowedObject<BinaryView>::Objects>
+    BinaryDataNotification::BorrowedObject<BinaryView>::m_objects;
+thread_local size_t BinaryDataNotification::BorrowedObject<BinaryView>::m_depth = 0;
+
+
 uint64_t BinaryDataNotification::NotificationBarrierCallback(void* ctxt, BNBinaryView* object)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	return notify->OnNotificationBarrier(view);
 }
 
@@ -49,7 +212,7 @@ uint64_t BinaryDataNotification::NotificationBarrierCallback(void* ctxt, BNBinar
 void BinaryDataNotification::DataWrittenCallback(void* ctxt, BNBinaryView* object, uint64_t offset, size_t len)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnBinaryDataWritten(view, offset, len);
 }
 
@@ -57,7 +220,7 @@ void BinaryDataNotification::DataWrittenCallback(void* ctxt, BNBinaryView* objec
 void BinaryDataNotification::DataInsertedCallback(void* ctxt, BNBinaryView* object, uint64_t offset, size_t len)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnBinaryDataInserted(view, offset, len);
 }
 
@@ -65,7 +228,7 @@ void BinaryDataNotification::DataInsertedCallback(void* ctxt, BNBinaryView* obje
 void BinaryDataNotification::DataRemovedCallback(void* ctxt, BNBinaryView* object, uint64_t offset, uint64_t len)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnBinaryDataRemoved(view, offset, len);
 }
 
@@ -73,8 +236,8 @@ void BinaryDataNotification::DataRemovedCallback(void* ctxt, BNBinaryView* objec
 void BinaryDataNotification::FunctionAddedCallback(void* ctxt, BNBinaryView* object, BNFunction* func)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Function> funcObj = new Function(BNNewFunctionReference(func));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Function> funcObj(func);
 	notify->OnAnalysisFunctionAdded(view, funcObj);
 }
 
@@ -82,8 +245,8 @@ void BinaryDataNotification::FunctionAddedCallback(void* ctxt, BNBinaryView* obj
 void BinaryDataNotification::FunctionRemovedCallback(void* ctxt, BNBinaryView* object, BNFunction* func)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Function> funcObj = new Function(BNNewFunctionReference(func));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Function> funcObj(func);
 	notify->OnAnalysisFunctionRemoved(view, funcObj);
 }
 
@@ -91,8 +254,8 @@ void BinaryDataNotification::FunctionRemovedCallback(void* ctxt, BNBinaryView* o
 void BinaryDataNotification::FunctionUpdatedCallback(void* ctxt, BNBinaryView* object, BNFunction* func)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Function> funcObj = new Function(BNNewFunctionReference(func));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Function> funcObj(func);
 	notify->OnAnalysisFunctionUpdated(view, funcObj);
 }
 
@@ -100,8 +263,8 @@ void BinaryDataNotification::FunctionUpdatedCallback(void* ctxt, BNBinaryView* o
 void BinaryDataNotification::FunctionUpdateRequestedCallback(void* ctxt, BNBinaryView* object, BNFunction* func)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Function> funcObj = new Function(BNNewFunctionReference(func));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Function> funcObj(func);
 	notify->OnAnalysisFunctionUpdateRequested(view, funcObj);
 }
 
@@ -109,7 +272,7 @@ void BinaryDataNotification::FunctionUpdateRequestedCallback(void* ctxt, BNBinar
 void BinaryDataNotification::DataVariableAddedCallback(void* ctxt, BNBinaryView* object, BNDataVariable* var)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	DataVariable varObj(var->address,
 	    Confidence<Ref<Type>>(new Type(BNNewTypeReference(var->type)), var->typeConfidence), var->autoDiscovered);
 	notify->OnDataVariableAdded(view, varObj);
@@ -119,7 +282,7 @@ void BinaryDataNotification::DataVariableAddedCallback(void* ctxt, BNBinaryView*
 void BinaryDataNotification::DataVariableRemovedCallback(void* ctxt, BNBinaryView* object, BNDataVariable* var)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	DataVariable varObj(var->address,
 	    Confidence<Ref<Type>>(new Type(BNNewTypeReference(var->type)), var->typeConfidence), var->autoDiscovered);
 	notify->OnDataVariableRemoved(view, varObj);
@@ -129,7 +292,7 @@ void BinaryDataNotification::DataVariableRemovedCallback(void* ctxt, BNBinaryVie
 void BinaryDataNotification::DataVariableUpdatedCallback(void* ctxt, BNBinaryView* object, BNDataVariable* var)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	DataVariable varObj(var->address,
 	    Confidence<Ref<Type>>(new Type(BNNewTypeReference(var->type)), var->typeConfidence), var->autoDiscovered);
 	notify->OnDataVariableUpdated(view, varObj);
@@ -139,7 +302,7 @@ void BinaryDataNotification::DataVariableUpdatedCallback(void* ctxt, BNBinaryVie
 void BinaryDataNotification::DataMetadataUpdatedCallback(void* ctxt, BNBinaryView* object, uint64_t offset)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnDataMetadataUpdated(view, offset);
 }
 
@@ -147,7 +310,7 @@ void BinaryDataNotification::DataMetadataUpdatedCallback(void* ctxt, BNBinaryVie
 void BinaryDataNotification::TagTypeUpdatedCallback(void* ctxt, BNBinaryView* object, BNTagType* tagType)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	Ref<TagType> tagTypeRef = new TagType(BNNewTagTypeReference(tagType));
 	notify->OnTagTypeUpdated(view, tagTypeRef);
 }
@@ -156,7 +319,7 @@ void BinaryDataNotification::TagTypeUpdatedCallback(void* ctxt, BNBinaryView* ob
 void BinaryDataNotification::TagAddedCallback(void* ctxt, BNBinaryView* object, BNTagReference* tagRef)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnTagAdded(view, TagReference(*tagRef));
 }
 
@@ -164,7 +327,7 @@ void BinaryDataNotification::TagAddedCallback(void* ctxt, BNBinaryView* object,
 void BinaryDataNotification::TagUpdatedCallback(void* ctxt, BNBinaryView* object, BNTagReference* tagRef)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnTagUpdated(view, TagReference(*tagRef));
 }
 
@@ -172,7 +335,7 @@ void BinaryDataNotification::TagUpdatedCallback(void* ctxt, BNBinaryView* object
 void BinaryDataNotification::TagRemovedCallback(void* ctxt, BNBinaryView* object, BNTagReference* tagRef)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnTagRemoved(view, TagReference(*tagRef));
 }
 
@@ -180,8 +343,8 @@ void BinaryDataNotification::TagRemovedCallback(void* ctxt, BNBinaryView* object
 void BinaryDataNotification::SymbolAddedCallback(void* ctxt, BNBinaryView* object, BNSymbol* symobj)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Symbol> sym = new Symbol(BNNewSymbolReference(symobj));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Symbol> sym(symobj);
 	notify->OnSymbolAdded(view, sym);
 }
 
@@ -189,8 +352,8 @@ void BinaryDataNotification::SymbolAddedCallback(void* ctxt, BNBinaryView* objec
 void BinaryDataNotification::SymbolUpdatedCallback(void* ctxt, BNBinaryView* object, BNSymbol* symobj)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Symbol> sym = new Symbol(BNNewSymbolReference(symobj));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Symbol> sym(symobj);
 	notify->OnSymbolUpdated(view, sym);
 }
 
@@ -198,8 +361,8 @@ void BinaryDataNotification::SymbolUpdatedCallback(void* ctxt, BNBinaryView* obj
 void BinaryDataNotification::SymbolRemovedCallback(void* ctxt, BNBinaryView* object, BNSymbol* symobj)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
-	Ref<Symbol> sym = new Symbol(BNNewSymbolReference(symobj));
+	BorrowedObject<BinaryView> view(object);
+	BorrowedObject<Symbol> sym(symobj);
 	notify->OnSymbolRemoved(view, sym);
 }
 
@@ -208,7 +371,7 @@ void BinaryDataNotification::StringFoundCallback(
     void* ctxt, BNBinaryView* object, BNStringType type, uint64_t offset, size_t len)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnStringFound(view, type, offset, len);
 }
 
@@ -217,7 +380,7 @@ void BinaryDataNotification::StringRemovedCallback(
     void* ctxt, BNBinaryView* object, BNStringType type, uint64_t offset, size_t len)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(object));
+	BorrowedObject<BinaryView> view(object);
 	notify->OnStringRemoved(view, type, offset, len);
 }
 
@@ -225,7 +388,7 @@ void BinaryDataNotification::StringRemovedCallback(
 void BinaryDataNotification::TypeDefinedCallback(void* ctxt, BNBinaryView* data, BNQualifiedName* name, BNType* type)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Type> typeObj = new Type(BNNewTypeReference(type));
 	notify->OnTypeDefined(view, QualifiedName::FromAPIObject(name), typeObj);
 }
@@ -234,7 +397,7 @@ void BinaryDataNotification::TypeDefinedCallback(void* ctxt, BNBinaryView* data,
 void BinaryDataNotification::TypeUndefinedCallback(void* ctxt, BNBinaryView* data, BNQualifiedName* name, BNType* type)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Type> typeObj = new Type(BNNewTypeReference(type));
 	notify->OnTypeUndefined(view, QualifiedName::FromAPIObject(name), typeObj);
 }
@@ -244,7 +407,7 @@ void BinaryDataNotification::TypeReferenceChangedCallback(
     void* ctxt, BNBinaryView* data, BNQualifiedName* name, BNType* type)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Type> typeObj = new Type(BNNewTypeReference(type));
 	notify->OnTypeReferenceChanged(view, QualifiedName::FromAPIObject(name), typeObj);
 }
@@ -254,7 +417,7 @@ void BinaryDataNotification::TypeFieldReferenceChangedCallback(
     void* ctxt, BNBinaryView* data, BNQualifiedName* name, uint64_t offset)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	notify->OnTypeFieldReferenceChanged(view, QualifiedName::FromAPIObject(name), offset);
 }
 
@@ -262,7 +425,7 @@ void BinaryDataNotification::TypeFieldReferenceChangedCallback(
 void BinaryDataNotification::SegmentAddedCallback(void* ctxt, BNBinaryView* data, BNSegment* segment)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Segment> segmentObj = new Segment(BNNewSegmentReference(segment));
 
 	notify->OnSegmentAdded(view, segmentObj);
@@ -272,7 +435,7 @@ void BinaryDataNotification::SegmentAddedCallback(void* ctxt, BNBinaryView* data
 void BinaryDataNotification::SegmentUpdatedCallback(void* ctxt, BNBinaryView* data, BNSegment* segment)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Segment> segmentObj = new Segment(BNNewSegmentReference(segment));
 
 	notify->OnSegmentUpdated(view, segmentObj);
@@ -282,7 +445,7 @@ void BinaryDataNotification::SegmentUpdatedCallback(void* ctxt, BNBinaryView* da
 void BinaryDataNotification::SegmentRemovedCallback(void* ctxt, BNBinaryView* data, BNSegment* segment)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Segment> segmentObj = new Segment(BNNewSegmentReference(segment));
 
 	notify->OnSegmentRemoved(view, segmentObj);
@@ -292,7 +455,7 @@ void BinaryDataNotification::SegmentRemovedCallback(void* ctxt, BNBinaryView* da
 void BinaryDataNotification::SectionAddedCallback(void* ctxt, BNBinaryView* data, BNSection* section)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Section> sectionObj = new Section(BNNewSectionReference(section));
 
 	notify->OnSectionAdded(view, sectionObj);
@@ -302,7 +465,7 @@ void BinaryDataNotification::SectionAddedCallback(void* ctxt, BNBinaryView* data
 void BinaryDataNotification::SectionUpdatedCallback(void* ctxt, BNBinaryView* data, BNSection* section)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Section> sectionObj = new Section(BNNewSectionReference(section));
 
 	notify->OnSectionUpdated(view, sectionObj);
@@ -312,7 +475,7 @@ void BinaryDataNotification::SectionUpdatedCallback(void* ctxt, BNBinaryView* da
 void BinaryDataNotification::SectionRemovedCallback(void* ctxt, BNBinaryView* data, BNSection* section)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Section> sectionObj = new Section(BNNewSectionReference(section));
 
 	notify->OnSectionRemoved(view, sectionObj);
@@ -321,7 +484,7 @@ void BinaryDataNotification::SectionRemovedCallback(void* ctxt, BNBinaryView* da
 void BinaryDataNotification::ComponentNameUpdatedCallback(void* ctxt, BNBinaryView* data, char *previousName, BNComponent* bnComponent)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
 	std::string prevName = previousName;
 	BNFreeString(previousName);
@@ -332,7 +495,7 @@ void BinaryDataNotification::ComponentNameUpdatedCallback(void* ctxt, BNBinaryVi
 void BinaryDataNotification::ComponentAddedCallback(void* ctxt, BNBinaryView* data, BNComponent* bnComponent)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
 	notify->OnComponentAdded(view, component);
 }
@@ -342,7 +505,7 @@ void BinaryDataNotification::ComponentRemovedCallback(void* ctxt, BNBinaryView*
 	BNComponent* bnComponent)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> formerParent = new Component(BNNewComponentReference(bnFormerParent));
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
 	notify->OnComponentRemoved(view, formerParent, component);
@@ -353,7 +516,7 @@ void BinaryDataNotification::ComponentMovedCallback(void* ctxt, BNBinaryView* da
 	BNComponent* bnNewParent, BNComponent* bnComponent)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> formerParent = new Component(BNNewComponentReference(bnFormerParent));
 	Ref<Component> newParent = new Component(BNNewComponentReference(bnNewParent));
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
@@ -365,9 +528,9 @@ void BinaryDataNotification::ComponentFunctionAddedCallback(void* ctxt, BNBinary
 	BNFunction* func)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
-	Ref<Function> function = new Function(BNNewFunctionReference(func));
+	BorrowedObject<Function> function(func);
 	notify->OnComponentFunctionAdded(view, component, function);
 }
 
@@ -376,9 +539,9 @@ void BinaryDataNotification::ComponentFunctionRemovedCallback(void* ctxt, BNBina
 	BNFunction* func)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
-	Ref<Function> function = new Function(BNNewFunctionReference(func));
+	BorrowedObject<Function> function(func);
 	notify->OnComponentFunctionRemoved(view, component, function);
 }
 
@@ -388,7 +551,7 @@ void BinaryDataNotification::ComponentDataVariableAddedCallback(void* ctxt, BNBi
 	BNDataVariable* var)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
 	DataVariable varObj(var->address,
 		Confidence<Ref<Type>>(new Type(BNNewTypeReference(var->type)), var->typeConfidence), var->autoDiscovered);
@@ -400,7 +563,7 @@ void BinaryDataNotification::ComponentDataVariableRemovedCallback(void* ctxt, BN
 	BNComponent* bnComponent, BNDataVariable* var)
 {
 	BinaryDataNotification* notify = (BinaryDataNotification*)ctxt;
-	Ref<BinaryView> view = new BinaryView(BNNewViewReference(data));
+	BorrowedObject<BinaryView> view(data);
 	Ref<Component> component = new Component(BNNewComponentReference(bnComponent));
 	DataVariable varObj(var->address,
 		Confidence<Ref<Type>>(new Type(BNNewTypeReference(var->type)), var->typeConfidence), var->autoDiscovered);
@@ -498,6 +661,147 @@ BinaryDataNotification::BinaryDataNotification(NotificationTypes notifications)
 }
 
 
+BatchedBinaryDataNotification::BatchedBinaryDataNotification(NotificationTypes notifications, uint64_t flushInterval) :
+    BinaryDataNotification(notifications | NotificationBarrier), m_flushInterval(flushInterval)
+{
+}
+
+
+BatchedBinaryDataNotification::~BatchedBinaryDataNotification()
+{
+}
+
+
+void BatchedBinaryDataNotification::FlushPendingWrites(PendingBatch& pending)
+{
+	for (auto& i : pending.writes)
+		pending.batch.dataUpdates.push_back({DataWrittenUpdate, i.first, i.second - i.first});
+	pending.writes.clear();
+}
+
+
+void BatchedBinaryDataNotification::AddDataUpdate(
+    BinaryView* view, BinaryDataUpdateType type, uint64_t offset, uint64_t len)
+{
+	if (len == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_batchMutex);
+	PendingBatch& pending = m_pending[view->GetObject()];
+
+	if (type == DataWrittenUpdate)
+	{
+		// Writes between two insertions or removals are kept as a set of disjoint ranges
+		uint64_t start = offset;
+		uint64_t end = offset + len;
+		auto i = pending.writes.upper_bound(start);
+		if (i != pending.writes.begin())
+		{
+			auto prev = std::prev(i);
+			if (prev->second >= start)
+			{
+				start = prev->first;
+				end = std::max(end, prev->second);
+				i = pending.writes.erase(prev);
+			}
+		}
+		while ((i != pending.writes.end()) && (i->first <= end))
+		{
+			end = std::max(end, i->second);
+			i = pending.writes.erase(i);
+		}
+		pending.writes[start] = end;
+		return;
+	}
+
+	// Insertions and removals shift later offsets, so earlier writes must be reported before them
+	FlushPendingWrites(pending);
+
+	if (!pending.batch.dataUpdates.empty())
+	{
+		BinaryDataUpdateRange& last = pending.batch.dataUpdates.back();
+		if ((type == DataInsertedUpdate) && (last.type == DataInsertedUpdate) && (offset >= last.offset)
+		    && (offset <= last.offset + last.length))
+		{
+			last.length += len;
+			return;
+		}
+		if ((type == DataRemovedUpdate) && (last.type == DataRemovedUpdate)
+		    && ((offset == last.offset) || (offset + len == last.offset)))
+		{
+			last.offset = offset;
+			last.length += len;
+			return;
+		}
+	}
+
+	pending.batch.dataUpdates.push_back({type, offset, len});
+}
+
+
+bool BatchedBinaryDataNotification::FlushBatch(BinaryView* view)
+{
+	BinaryDataNotificationBatch batch;
+	{
+		std::lock_guard<std::mutex> lock(m_batchMutex);
+		auto i = m_pending.find(view->GetObject());
+		if (i == m_pending.end())
+			return false;
+		FlushPendingWrites(i->second);
+		batch = std::move(i->second.batch);
+		m_pending.erase(i);
+	}
+
+	if (batch.IsEmpty())
+		return false;
+	OnBinaryDataBatch(view, batch);
+	return true;
+}
+
+
+uint64_t BatchedBinaryDataNotification::OnNotificationBarrier(BinaryView* view)
+{
+	if (!FlushBatch(view))
+		return 0;
+	return m_flushInterval;
+}
+
+
+void BatchedBinaryDataNotification::OnBinaryDataWritten(BinaryView* view, uint64_t offset, size_t len)
+{
+	AddDataUpdate(view, DataWrittenUpdate, offset, len);
+}
+
+
+void BatchedBinaryDataNotification::OnBinaryDataInserted(BinaryView* view, uint64_t offset, size_t len)
+{
+	AddDataUpdate(view, DataInsertedUpdate, offset, len);
+}
+
+
+void BatchedBinaryDataNotification::OnBinaryDataRemoved(BinaryView* view, uint64_t offset, uint64_t len)
+{
+	AddDataUpdate(view, DataRemovedUpdate, offset, len);
+}
+
+
+void BatchedBinaryDataNotification::OnAnalysisFunctionUpdated(BinaryView* view, Function* func)
+{
+	std::lock_guard<std::mutex> lock(m_batchMutex);
+	PendingBatch& pending = m_pending[view->GetObject()];
+	if (pending.functions.insert(func->GetObject()).second)
+		pending.batch.updatedFunctions.push_back(func);
+}
+
+
+void BatchedBinaryDataNotification::OnSymbolAdded(BinaryView* view, Symbol* sym)
+{
+	std::lock_guard<std::mutex> lock(m_batchMutex);
+	PendingBatch& pending = m_pending[view->GetObject()];
+	if (pending.symbols.insert(sym->GetObject()).second)
+		pending.batch.addedSymbols.push_back(sym);
+}
+
 Symbol::Symbol(BNSymbolType type, const string& shortName, const string& fullName, const string& rawName, uint64_t addr,
     BNSymbolBinding binding, const NameSpace& nameSpace, uint64_t ordinal)
 {
@@ -1479,6 +1783,14 @@ bool BinaryView::Navigate(const string& view, uint64_t offset)
 
 DataBuffer BinaryView::ReadBuffer(uint64_t offset, size_t len)
 {
+	if (len <= DataBuffer::InlineCapacity)
+	{
+		// Short reads go straight into the inline storage of the result
+		DataBuffer result(len);
+		result.SetSize(BNReadViewData(m_object, result.GetData(), offset, len));
+		return result;
+	}
+
 	BNDataBuffer* result = BNReadViewBuffer(m_object, offset, len);
 	return DataBuffer(result);
 }
@@ -1486,13 +1798,13 @@ DataBuffer BinaryView::ReadBuffer(uint64_t offset, size_t len)
 
 size_t BinaryView::WriteBuffer(uint64_t offset, const DataBuffer& data)
 {
-	return BNWriteViewBuffer(m_object, offset, data.GetBufferObject());
+	return BNWriteViewData(m_object, offset, data.GetData(), data.GetLength());
 }
 
 
 size_t BinaryView::InsertBuffer(uint64_t offset, const DataBuffer& data)
 {
-	return BNInsertViewBuffer(m_object, offset, data.GetBufferObject());
+	return BNInsertViewData(m_object, offset, data.GetData(), data.GetLength());
 }
 
 
@@ -4104,6 +4416,379 @@ bool BinaryView::FindAllConstant(uint64_t start, uint64_t end, uint64_t constant
 }
 
 
+
+static int GetPatternNibble(char c)
+{
+	if ((c >= '0') && (c <= '9'))
+		return c - '0';
+	if ((c >= 'a') && (c <= 'f'))
+		return c - 'a' + 10;
+	if ((c >= 'A') && (c <= 'F'))
+		return c - 'A' + 10;
+	if (c == '?')
+		return -1;
+	return -2;
+}
+
+
+bool BinaryPattern::FromString(const string& text, BinaryPattern& result)
+{
+	result.bytes.clear();
+	result.mask.clear();
+	for (size_t i = 0; i < text.size();)
+	{
+		if (isspace((unsigned char)text[i]))
+		{
+			i++;
+			continue;
+		}
+
+		int high = GetPatternNibble(text[i]);
+		int low = (i + 1 < text.size()) ? GetPatternNibble(text[i + 1]) : -2;
+		if (high == -2)
+			return false;
+		if (low == -2)
+		{
+			// A lone "?" stands for a whole wildcard byte
+			if ((high != -1) || ((i + 1 < text.size()) && !isspace((unsigned char)text[i + 1])))
+				return false;
+			result.bytes.push_back(0);
+			result.mask.push_back(0);
+			i++;
+			continue;
+		}
+
+		result.bytes.push_back((uint8_t)(((high < 0 ? 0 : high) << 4) | (low < 0 ? 0 : low)));
+		result.mask.push_back((uint8_t)((high < 0 ? 0 : 0xf0) | (low < 0 ? 0 : 0x0f)));
+		i += 2;
+	}
+	return !result.bytes.empty();
+}
+
+
+namespace
+{
+	// Aho-Corasick automaton over the longest exact run of each pattern, with full pattern verification on hits
+	class BinaryPatternAutomaton
+	{
+		struct Anchor
+		{
+			size_t pattern;
+			size_t offset;
+			size_t length;
+		};
+
+		const vector<BinaryPattern>& m_patterns;
+		vector<uint32_t> m_next;
+		vector<vector<uint32_t>> m_outputs;
+		vector<Anchor> m_anchors;
+		vector<size_t> m_unanchored;
+		size_t m_maxLength = 0;
+
+		uint8_t GetMask(const BinaryPattern& pattern, size_t i) const
+		{
+			return (i < pattern.mask.size()) ? pattern.mask[i] : 0xff;
+		}
+
+		bool Matches(const BinaryPattern& pattern, const uint8_t* data, size_t len) const
+		{
+			if (pattern.bytes.size() > len)
+				return false;
+			for (size_t i = 0; i < pattern.bytes.size(); i++)
+			{
+				uint8_t mask = GetMask(pattern, i);
+				if ((data[i] & mask) != (pattern.bytes[i] & mask))
+					return false;
+			}
+			return true;
+		}
+
+	  public:
+		BinaryPatternAutomaton(const vector<BinaryPattern>& patterns) : m_patterns(patterns)
+		{
+			static constexpr uint32_t None = UINT32_MAX;
+			m_next.resize(256, None);
+			m_outputs.emplace_back();
+
+			for (size_t p = 0; p < patterns.size(); p++)
+			{
+				const BinaryPattern& pattern = patterns[p];
+				if (pattern.bytes.empty())
+					continue;
+				m_maxLength = max(m_maxLength, pattern.bytes.size());
+
+				Anchor anchor {p, 0, 0};
+				for (size_t i = 0; i < pattern.bytes.size();)
+				{
+					size_t runEnd = i;
+					while ((runEnd < pattern.bytes.size()) && (GetMask(pattern, runEnd) == 0xff))
+						runEnd++;
+					if (runEnd - i > anchor.length)
+						anchor = {p, i, runEnd - i};
+					i = runEnd + 1;
+				}
+				if (anchor.length == 0)
+				{
+					m_unanchored.push_back(p);
+					continue;
+				}
+
+				uint32_t state = 0;
+				for (size_t i = anchor.offset; i < anchor.offset + anchor.length; i++)
+				{
+					uint32_t& next = m_next[(size_t)state * 256 + pattern.bytes[i]];
+					if (next == None)
+					{
+						next = (uint32_t)m_outputs.size();
+						m_outputs.emplace_back();
+						m_next.resize(m_next.size() + 256, None);
+					}
+					state = m_next[(size_t)state * 256 + pattern.bytes[i]];
+				}
+				m_outputs[state].push_back((uint32_t)m_anchors.size());
+				m_anchors.push_back(anchor);
+			}
+
+			// Breadth first construction of failure links, folded directly into a dense transition table
+			vector<uint32_t> fail(m_outputs.size(), 0);
+			vector<uint32_t> queue;
+			for (size_t c = 0; c < 256; c++)
+			{
+				if (m_next[c] == None)
+				{
+					m_next[c] = 0;
+				}
+				else
+				{
+					fail[m_next[c]] = 0;
+					queue.push_back(m_next[c]);
+				}
+			}
+			for (size_t q = 0; q < queue.size(); q++)
+			{
+				uint32_t state = queue[q];
+				const vector<uint32_t>& inherited = m_outputs[fail[state]];
+				m_outputs[state].insert(m_outputs[state].end(), inherited.begin(), inherited.end());
+				for (size_t c = 0; c < 256; c++)
+				{
+					uint32_t& next = m_next[(size_t)state * 256 + c];
+					uint32_t fallback = m_next[(size_t)fail[state] * 256 + c];
+					if (next == None)
+					{
+						next = fallback;
+					}
+					else
+					{
+						fail[next] = fallback;
+						queue.push_back(next);
+					}
+				}
+			}
+		}
+
+		size_t GetMaxLength() const { return m_maxLength; }
+
+		/*! Find matches starting in the first \c limit bytes of \c data, which begins at address \c base */
+		void Scan(const uint8_t* data, size_t len, size_t limit, uint64_t base, vector<BinaryPatternMatch>& out) const
+		{
+			size_t scanEnd = min(len, limit + m_maxLength);
+			uint32_t state = 0;
+			for (size_t i = 0; i < scanEnd; i++)
+			{
+				state = m_next[(size_t)state * 256 + data[i]];
+				for (uint32_t index : m_outputs[state])
+				{
+					const Anchor& anchor = m_anchors[index];
+					size_t anchorStart = i + 1 - anchor.length;
+					if (anchorStart < anchor.offset)
+						continue;
+					size_t matchStart = anchorStart - anchor.offset;
+					if (matchStart >= limit)
+						continue;
+					if (Matches(m_patterns[anchor.pattern], data + matchStart, len - matchStart))
+						out.push_back({anchor.pattern, base + matchStart});
+				}
+			}
+
+			for (size_t pattern : m_unanchored)
+			{
+				for (size_t i = 0; i < min(len, limit); i++)
+				{
+					if (Matches(m_patterns[pattern], data + i, len - i))
+						out.push_back({pattern, base + i});
+				}
+			}
+
+			sort(out.begin(), out.end(), [](const BinaryPatternMatch& a, const BinaryPatternMatch& b) {
+				if (a.address != b.address)
+					return a.address < b.address;
+				return a.patternId < b.patternId;
+			});
+		}
+	};
+}  // namespace
+
+
+bool BinaryView::FindAllPatterns(uint64_t start, uint64_t end, const vector<BinaryPattern>& patterns,
+    const function<bool(size_t current, size_t total)>& progress,
+    const function<bool(const BinaryPatternMatch& match)>& matchCallback)
+{
+	static constexpr uint64_t ChunkSize = 0x100000;
+
+	BinaryPatternAutomaton automaton(patterns);
+	if (automaton.GetMaxLength() == 0)
+		return true;
+
+	// Searchable regions are the segments overlapping the range, with adjacent segments joined
+	vector<pair<uint64_t, uint64_t>> regions;
+	vector<Ref<Segment>> segments = GetSegments();
+	if (segments.empty())
+	{
+		if (start < end)
+			regions.push_back({start, end});
+	}
+	for (auto& segment : segments)
+	{
+		uint64_t regionStart = max(start, segment->GetStart());
+		uint64_t regionEnd = min(end, segment->GetEnd());
+		if (regionStart < regionEnd)
+			regions.push_back({regionStart, regionEnd});
+	}
+	sort(regions.begin(), regions.end());
+	vector<pair<uint64_t, uint64_t>> merged;
+	for (auto& region : regions)
+	{
+		if (!merged.empty() && (region.first <= merged.back().second))
+			merged.back().second = max(merged.back().second, region.second);
+		else
+			merged.push_back(region);
+	}
+
+	struct Chunk
+	{
+		uint64_t start;
+		uint64_t length;
+		uint64_t regionEnd;
+	};
+	vector<Chunk> chunks;
+	for (auto& region : merged)
+	{
+		for (uint64_t addr = region.first; addr < region.second; addr += min(ChunkSize, region.second - addr))
+			chunks.push_back({addr, min(ChunkSize, region.second - addr), region.second});
+	}
+	if (chunks.empty())
+		return true;
+
+	// Chunks are claimed in order by pool tasks and by this thread, and delivered by this thread in the same order
+	vector<vector<BinaryPatternMatch>> results(chunks.size());
+	vector<bool> done(chunks.size(), false);
+	exception_ptr failure;
+	atomic<size_t> nextChunk(0);
+	mutex resultMutex;
+	condition_variable resultReady;
+	size_t maxLength = automaton.GetMaxLength();
+
+	TaskGroup group("FindAllPatterns");
+	auto scanNext = [&](vector<uint8_t>& buffer) {
+		if (group.IsCancelled())
+			return false;
+		size_t index = nextChunk++;
+		if (index >= chunks.size())
+			return false;
+		const Chunk& chunk = chunks[index];
+		vector<BinaryPatternMatch> matches;
+		try
+		{
+			size_t readLength = (size_t)min<uint64_t>(chunk.length + maxLength - 1, chunk.regionEnd - chunk.start);
+			buffer.resize(readLength);
+			size_t len = BNReadViewData(m_object, buffer.data(), chunk.start, readLength);
+			automaton.Scan(buffer.data(), len, (size_t)min<uint64_t>(chunk.length, len), chunk.start, matches);
+		}
+		catch (...)
+		{
+			// The claimed chunk will never complete, so hand the error to the thread delivering results
+			group.Cancel();
+			lock_guard<mutex> lock(resultMutex);
+			if (!failure)
+				failure = current_exception();
+			resultReady.notify_all();
+			return false;
+		}
+
+		lock_guard<mutex> lock(resultMutex);
+		results[index] = std::move(matches);
+		done[index] = true;
+		resultReady.notify_all();
+		return true;
+	};
+
+	// Stop outstanding tasks on every exit path, including callbacks that throw
+	struct CancelGuard
+	{
+		TaskGroup& group;
+		~CancelGuard()
+		{
+			group.Cancel();
+			try
+			{
+				group.Wait();
+			}
+			catch (...)
+			{
+			}
+		}
+	} cancelGuard {group};
+
+	size_t taskCount = min<size_t>(max<size_t>(GetWorkerThreadCount(), 1), chunks.size());
+	for (size_t i = 0; i < taskCount; i++)
+	{
+		group.Run([&]() {
+			vector<uint8_t> buffer;
+			while (scanNext(buffer))
+				;
+		});
+	}
+
+	bool completed = true;
+	vector<uint8_t> buffer;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		vector<BinaryPatternMatch> matches;
+		{
+			unique_lock<mutex> lock(resultMutex);
+			while (!done[i] && !failure)
+			{
+				// Scan unclaimed chunks here rather than blocking, the pool may be busy or this may be a worker
+				if (nextChunk < chunks.size())
+				{
+					lock.unlock();
+					scanNext(buffer);
+					lock.lock();
+					continue;
+				}
+				resultReady.wait(lock);
+			}
+			if (failure)
+				rethrow_exception(failure);
+			matches = std::move(results[i]);
+		}
+
+		for (auto& match : matches)
+		{
+			if (!matchCallback(match))
+			{
+				completed = false;
+				break;
+			}
+		}
+		if (completed && progress && !progress(i + 1, chunks.size()))
+			completed = false;
+		if (!completed)
+			break;
+	}
+	return completed;
+}
+
 void BinaryView::Reanalyze()
 {
 	BNReanalyzeAllFunctions(m_object);
@@ -232,3 +232,88 @@ void BinaryWriter::SeekRelative(int64_t offset)
 {
 	BNSeekBinaryWriterRelative(m_stream, offset);
 }
+
+
+BatchedBinaryWriter::BatchedBinaryWriter(BinaryView* data, BNEndianness endian) :
+    m_view(data), m_endian(endian), m_offset(data->GetStart())
+{
+}
+
+
+void BatchedBinaryWriter::AddExtent(uint64_t offset, const uint8_t* data, size_t len)
+{
+	if (len == 0)
+		return;
+
+	// Find the run of extents that overlap or touch the new range
+	uint64_t end = offset + len;
+	auto first = m_extents.upper_bound(offset);
+	if (first != m_extents.begin())
+	{
+		auto prev = std::prev(first);
+		if (prev->first + prev->second.size() >= offset)
+			first = prev;
+	}
+	auto last = first;
+	while ((last != m_extents.end()) && (last->first <= end))
+	{
+		end = std::max(end, last->first + last->second.size());
+		++last;
+	}
+
+	if (first == last)
+	{
+		m_extents.emplace_hint(last, offset, std::vector<uint8_t>(data, data + len));
+		return;
+	}
+
+	// Extend the first extent in place when possible, which keeps sequential writes cheap
+	uint64_t start = std::min(offset, first->first);
+	bool reuseFirst = first->first == start;
+	std::vector<uint8_t> merged;
+	if (reuseFirst)
+		merged = std::move(first->second);
+	merged.resize(end - start);
+	for (auto i = reuseFirst ? std::next(first) : first; i != last; ++i)
+		memcpy(&merged[i->first - start], i->second.data(), i->second.size());
+	memcpy(&merged[offset - start], data, len);
+
+	if (reuseFirst)
+	{
+		first->second = std::move(merged);
+		m_extents.erase(std::next(first), last);
+	}
+	else
+	{
+		m_extents.erase(first, last);
+		m_extents.emplace(start, std::move(merged));
+	}
+}
+
+
+void BatchedBinaryWriter::Write(const void* src, size_t len)
+{
+	AddExtent(m_offset, (const uint8_t*)src, len);
+	m_offset += len;
+}
+
+
+bool BatchedBinaryWriter::Commit()
+{
+	if (m_extents.empty())
+		return true;
+
+	string undo = m_view->BeginUndoActions(false);
+	for (auto& i : m_extents)
+	{
+		if (m_view->Write(i.first, i.second.data(), i.second.size()) != i.second.size())
+		{
+			m_view->RevertUndoActions(undo);
+			return false;
+		}
+	}
+	m_view->CommitUndoActions(undo);
+	m_extents.clear();
+	return true;
+}
+
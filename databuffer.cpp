@@ -18,50 +18,72 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 
+#include <cstring>
 #include "binaryninjaapi.h"
 
 using namespace BinaryNinja;
 using namespace std;
 
 
-DataBuffer::DataBuffer()
+DataBuffer::DataBuffer() : m_buffer(nullptr), m_inlineLength(0)
 {
-	m_buffer = BNCreateDataBuffer(nullptr, 0);
 }
 
 
-DataBuffer::DataBuffer(size_t len)
+DataBuffer::DataBuffer(size_t len) : m_buffer(nullptr), m_inlineLength(0)
 {
-	m_buffer = BNCreateDataBuffer(nullptr, len);
+	if (len <= InlineCapacity)
+	{
+		memset(m_inline, 0, len);
+		m_inlineLength = (uint8_t)len;
+	}
+	else
+	{
+		m_buffer = BNCreateDataBuffer(nullptr, len);
+	}
 }
 
 
-DataBuffer::DataBuffer(const void* data, size_t len)
+DataBuffer::DataBuffer(const void* data, size_t len) : m_buffer(nullptr), m_inlineLength(0)
 {
-	m_buffer = BNCreateDataBuffer(data, len);
+	if (len <= InlineCapacity)
+	{
+		if (len != 0)
+			memcpy(m_inline, data, len);
+		m_inlineLength = (uint8_t)len;
+	}
+	else
+	{
+		m_buffer = BNCreateDataBuffer(data, len);
+	}
 }
 
 
-DataBuffer::DataBuffer(const DataBuffer& buf)
+DataBuffer::DataBuffer(const DataBuffer& buf) : m_buffer(nullptr), m_inlineLength(buf.m_inlineLength)
 {
-	m_buffer = BNDuplicateDataBuffer(buf.m_buffer);
+	if (buf.m_buffer)
+		m_buffer = BNDuplicateDataBuffer(buf.m_buffer);
+	else
+		memcpy(m_inline, buf.m_inline, m_inlineLength);
 }
 
-DataBuffer::DataBuffer(DataBuffer&& buf)
+DataBuffer::DataBuffer(DataBuffer&& buf) : m_buffer(buf.m_buffer), m_inlineLength(buf.m_inlineLength)
 {
-	m_buffer = buf.m_buffer;
-	buf.m_buffer = BNCreateDataBuffer(nullptr, 0);
+	if (!m_buffer)
+		memcpy(m_inline, buf.m_inline, m_inlineLength);
+	buf.m_buffer = nullptr;
+	buf.m_inlineLength = 0;
 }
 
-DataBuffer::DataBuffer(BNDataBuffer* buf)
+DataBuffer::DataBuffer(BNDataBuffer* buf) : m_buffer(buf), m_inlineLength(0)
 {
-	m_buffer = buf;
 }
 
 
 DataBuffer::~DataBuffer()
 {
-	BNFreeDataBuffer(m_buffer);
+	if (m_buffer)
+		BNFreeDataBuffer(m_buffer);
 }
 
 
@@ -69,8 +91,12 @@ DataBuffer& DataBuffer::operator=(const DataBuffer& buf)
 {
 	if (this != &buf)
 	{
-		BNFreeDataBuffer(m_buffer);
-		m_buffer = BNDuplicateDataBuffer(buf.m_buffer);
+		if (m_buffer)
+			BNFreeDataBuffer(m_buffer);
+		m_buffer = buf.m_buffer ? BNDuplicateDataBuffer(buf.m_buffer) : nullptr;
+		m_inlineLength = buf.m_inlineLength;
+		if (!m_buffer)
+			memcpy(m_inline, buf.m_inline, m_inlineLength);
 	}
 
 	return *this;
@@ -80,15 +106,33 @@ DataBuffer& DataBuffer::operator=(DataBuffer&& buf)
 {
 	if (this != &buf)
 	{
-		BNClearDataBuffer(m_buffer);
-		BNDataBuffer* temp = m_buffer;
+		if (m_buffer)
+			BNFreeDataBuffer(m_buffer);
 		m_buffer = buf.m_buffer;
-		buf.m_buffer = temp;
+		m_inlineLength = buf.m_inlineLength;
+		if (!m_buffer)
+			memcpy(m_inline, buf.m_inline, m_inlineLength);
+		buf.m_buffer = nullptr;
+		buf.m_inlineLength = 0;
 	}
 
 	return *this;
 }
 
+
+void DataBuffer::Materialize() const
+{
+	if (!m_buffer)
+		m_buffer = BNCreateDataBuffer(m_inline, m_inlineLength);
+}
+
+
+BNDataBuffer* DataBuffer::GetBufferObject() const
+{
+	Materialize();
+	return m_buffer;
+}
+
 bool DataBuffer::operator==(const DataBuffer& other) const
 {
 	uint8_t* data = (uint8_t*)GetData();
@@ -113,55 +157,92 @@ bool DataBuffer::operator!=(const DataBuffer& other) const
 
 void* DataBuffer::GetData()
 {
+	if (!m_buffer)
+		return m_inline;
 	return BNGetDataBufferContents(m_buffer);
 }
 
 
 const void* DataBuffer::GetData() const
 {
+	if (!m_buffer)
+		return m_inline;
 	return BNGetDataBufferContents(m_buffer);
 }
 
 
 void* DataBuffer::GetDataAt(size_t offset)
 {
+	if (!m_buffer)
+		return m_inline + offset;
 	return BNGetDataBufferContentsAt(m_buffer, offset);
 }
 
 
 const void* DataBuffer::GetDataAt(size_t offset) const
 {
+	if (!m_buffer)
+		return m_inline + offset;
 	return BNGetDataBufferContentsAt(m_buffer, offset);
 }
 
 
 size_t DataBuffer::GetLength() const
 {
+	if (!m_buffer)
+		return m_inlineLength;
 	return BNGetDataBufferLength(m_buffer);
 }
 
 
 void DataBuffer::SetSize(size_t len)
 {
+	if (!m_buffer && (len <= InlineCapacity))
+	{
+		if (len > m_inlineLength)
+			memset(m_inline + m_inlineLength, 0, len - m_inlineLength);
+		m_inlineLength = (uint8_t)len;
+		return;
+	}
+
+	Materialize();
 	BNSetDataBufferLength(m_buffer, len);
 }
 
 
 void DataBuffer::Clear()
 {
-	BNClearDataBuffer(m_buffer);
+	if (m_buffer)
+		BNClearDataBuffer(m_buffer);
+	m_inlineLength = 0;
 }
 
 
 void DataBuffer::Append(const void* data, size_t len)
 {
+	if (!m_buffer && (len <= InlineCapacity - m_inlineLength))
+	{
+		if (len != 0)
+			memcpy(m_inline + m_inlineLength, data, len);
+		m_inlineLength += (uint8_t)len;
+		return;
+	}
+
+	Materialize();
 	BNAppendDataBufferContents(m_buffer, data, len);
 }
 
 
 void DataBuffer::Append(const DataBuffer& buf)
 {
-	BNAppendDataBuffer(m_buffer, buf.m_buffer);
+	if (!m_buffer && !buf.m_buffer && (buf.m_inlineLength <= InlineCapacity - m_inlineLength))
+	{
+		Append(buf.m_inline, buf.m_inlineLength);
+		return;
+	}
+
+	// Let the core append buffers so that appending a buffer to itself is safe
+	BNAppendDataBuffer(GetBufferObject(), buf.GetBufferObject());
 }
 
 
@@ -173,7 +254,12 @@ void DataBuffer::AppendByte(uint8_t val)
 
 DataBuffer DataBuffer::GetSlice(size_t start, size_t len)
 {
-	BNDataBuffer* result = BNGetDataBufferSlice(m_buffer, start, len);
+	// Short in-range slices are copied inline, everything else keeps the core's slicing behavior
+	size_t length = GetLength();
+	if ((len <= InlineCapacity) && (start <= length) && (len <= length - start))
+		return DataBuffer(GetDataAt(start), len);
+
+	BNDataBuffer* result = BNGetDataBufferSlice(GetBufferObject(), start, len);
 	return DataBuffer(result);
 }
 
@@ -192,7 +278,7 @@ const uint8_t& DataBuffer::operator[](size_t offset) const
 
 string DataBuffer::ToEscapedString(bool nullTerminates) const
 {
-	char* str = BNDataBufferToEscapedString(m_buffer, nullTerminates);
+	char* str = BNDataBufferToEscapedString(GetBufferObject(), nullTerminates);
 	string result = str;
 	BNFreeString(str);
 	return result;
@@ -207,7 +293,7 @@ DataBuffer DataBuffer::FromEscapedString(const string& src)
 
 string DataBuffer::ToBase64() const
 {
-	char* str = BNDataBufferToBase64(m_buffer);
+	char* str = BNDataBufferToBase64(GetBufferObject());
 	string result = str;
 	BNFreeString(str);
 	return result;
@@ -222,7 +308,7 @@ DataBuffer DataBuffer::FromBase64(const string& src)
 
 bool DataBuffer::ZlibCompress(DataBuffer& output) const
 {
-	BNDataBuffer* result = BNZlibCompress(output.m_buffer);
+	BNDataBuffer* result = BNZlibCompress(output.GetBufferObject());
 	if (!result)
 		return false;
 	output = DataBuffer(result);
@@ -232,7 +318,7 @@ bool DataBuffer::ZlibCompress(DataBuffer& output) const
 
 bool DataBuffer::ZlibDecompress(DataBuffer& output) const
 {
-	BNDataBuffer* result = BNZlibDecompress(output.m_buffer);
+	BNDataBuffer* result = BNZlibDecompress(output.GetBufferObject());
 	if (!result)
 		return false;
 	output = DataBuffer(result);
@@ -240,6 +326,12 @@ bool DataBuffer::ZlibDecompress(DataBuffer& output) const
 }
 
 
+DataBuffer DataBufferView::ToDataBuffer() const
+{
+	return DataBuffer(m_data, m_length);
+}
+
+
 string BinaryNinja::EscapeString(const string& s)
 {
 	DataBuffer buffer(s.c_str(), s.size());
@@ -1,7 +1,94 @@
 #include "binaryninjaapi.h"
+#include <list>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 using namespace std;
 
+namespace
+{
+	// Batches smaller than this are demangled on the calling thread
+	constexpr size_t ParallelDemangleThreshold = 256;
+	constexpr size_t ParallelDemangleGrain = 64;
+
+	struct DemangledName
+	{
+		bool demangled = false;
+		BinaryNinja::Ref<BinaryNinja::Type> type;
+		vector<string> components;
+	};
+
+	class DemangleCache
+	{
+		typedef list<pair<string, shared_ptr<const DemangledName>>> EntryList;
+
+		mutex m_mutex;
+		size_t m_capacity = 65536;
+		EntryList m_entries;  // Most recently used first
+		unordered_map<string_view, EntryList::iterator> m_index;
+
+		void Trim()
+		{
+			while (m_entries.size() > m_capacity)
+			{
+				m_index.erase(m_entries.back().first);
+				m_entries.pop_back();
+			}
+		}
+
+	  public:
+		static string MakeKey(BNArchitecture* arch, const BinaryNinja::DemangleBatchOptions& options, string_view name)
+		{
+			string key(reinterpret_cast<const char*>(&arch), sizeof(arch));
+			key += (char)options.style;
+			key += (char)options.simplify;
+			key += name;
+			return key;
+		}
+
+		shared_ptr<const DemangledName> Find(const string& key)
+		{
+			lock_guard<mutex> lock(m_mutex);
+			auto found = m_index.find(key);
+			if (found == m_index.end())
+				return nullptr;
+			m_entries.splice(m_entries.begin(), m_entries, found->second);
+			return found->second->second;
+		}
+
+		void Insert(string key, shared_ptr<const DemangledName> value)
+		{
+			lock_guard<mutex> lock(m_mutex);
+			if (m_capacity == 0 || m_index.find(key) != m_index.end())
+				return;
+			m_entries.emplace_front(std::move(key), std::move(value));
+			m_index[m_entries.front().first] = m_entries.begin();
+			Trim();
+		}
+
+		void SetCapacity(size_t capacity)
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_capacity = capacity;
+			Trim();
+		}
+
+		void Clear()
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_index.clear();
+			m_entries.clear();
+		}
+	};
+
+	DemangleCache& GetDemangleCache()
+	{
+		static DemangleCache cache;
+		return cache;
+	}
+}  // namespace
+
 namespace BinaryNinja {
 	bool DemangleMS(Architecture* arch, const std::string& mangledName, Ref<Type>& outType, QualifiedName& outVarName,
 	    BinaryView* view)
@@ -55,6 +142,145 @@ namespace BinaryNinja {
 	}
 
 
+	DemangleBatchOptions DemangleBatchOptions::ForView(BinaryView* view, DemangleStyle style)
+	{
+		DemangleBatchOptions options;
+		options.style = style;
+		options.simplify = Settings::Instance()->Get<bool>("analysis.types.templateSimplifier", view);
+		return options;
+	}
+
+
+	Ref<Type> DemangleBatchResult::GetType(size_t i) const
+	{
+		const Entry& entry = m_entries[m_entryForName[i]];
+		if (entry.typeIndex == (size_t)-1)
+			return nullptr;
+		return m_types[entry.typeIndex];
+	}
+
+
+	QualifiedName DemangleBatchResult::GetName(size_t i) const
+	{
+		QualifiedName name;
+		for (size_t j = 0; j < GetComponentCount(i); j++)
+			name.push_back(GetComponent(i, j));
+		return name;
+	}
+
+
+	static void DemangleOne(Architecture* arch, const string& mangledName, const DemangleBatchOptions& options,
+	    DemangledName& result)
+	{
+		QualifiedName name;
+		bool ms = options.style == MSDemangleStyle
+		    || (options.style == AutoDemangleStyle && !mangledName.empty() && mangledName[0] == '?');
+		if (ms)
+			result.demangled = DemangleMS(arch, mangledName, result.type, name, options.simplify);
+		else
+			result.demangled = DemangleGNU3(arch, mangledName, result.type, name, options.simplify);
+		if (!result.demangled)
+		{
+			result.type = nullptr;
+			return;
+		}
+		result.components.reserve(name.size());
+		for (size_t i = 0; i < name.size(); i++)
+			result.components.push_back(name[i]);
+	}
+
+
+	DemangleBatchResult DemangleBatch(
+	    Architecture* arch, const vector<string>& names, const DemangleBatchOptions& options)
+	{
+		DemangleBatchResult result;
+		result.m_entryForName.reserve(names.size());
+
+		// Collapse repeated names so each distinct one is looked up and demangled once
+		vector<const string*> uniqueNames;
+		unordered_map<string_view, size_t> uniqueIndex;
+		uniqueIndex.reserve(names.size());
+		for (const string& name : names)
+		{
+			auto inserted = uniqueIndex.emplace(name, uniqueNames.size());
+			if (inserted.second)
+				uniqueNames.push_back(&name);
+			result.m_entryForName.push_back(inserted.first->second);
+		}
+
+		DemangleCache& cache = GetDemangleCache();
+		vector<shared_ptr<const DemangledName>> demangled(uniqueNames.size());
+		vector<string> keys(uniqueNames.size());
+		vector<size_t> misses;
+		for (size_t i = 0; i < uniqueNames.size(); i++)
+		{
+			keys[i] = DemangleCache::MakeKey(arch->GetObject(), options, *uniqueNames[i]);
+			demangled[i] = cache.Find(keys[i]);
+			if (!demangled[i])
+				misses.push_back(i);
+		}
+
+		auto demangleMiss = [&](size_t i) {
+			auto name = make_shared<DemangledName>();
+			DemangleOne(arch, *uniqueNames[misses[i]], options, *name);
+			demangled[misses[i]] = std::move(name);
+		};
+		if (options.parallel && misses.size() >= ParallelDemangleThreshold)
+			ParallelFor(0, misses.size(), ParallelDemangleGrain, demangleMiss);
+		else
+			for (size_t i = 0; i < misses.size(); i++)
+				demangleMiss(i);
+
+		for (size_t i : misses)
+			cache.Insert(std::move(keys[i]), demangled[i]);
+
+		size_t textSize = 0;
+		size_t componentCount = 0;
+		for (auto& name : demangled)
+		{
+			componentCount += name->components.size();
+			for (auto& component : name->components)
+				textSize += component.size() + 1;
+		}
+		result.m_text.reserve(textSize);
+		result.m_componentOffsets.reserve(componentCount);
+		result.m_entries.reserve(demangled.size());
+		for (auto& name : demangled)
+		{
+			DemangleBatchResult::Entry entry;
+			entry.demangled = name->demangled;
+			entry.firstComponent = result.m_componentOffsets.size();
+			entry.componentCount = name->components.size();
+			entry.typeIndex = (size_t)-1;
+			if (name->type)
+			{
+				entry.typeIndex = result.m_types.size();
+				result.m_types.push_back(name->type);
+			}
+			for (auto& component : name->components)
+			{
+				result.m_componentOffsets.push_back(result.m_text.size());
+				result.m_text.insert(result.m_text.end(), component.begin(), component.end());
+				result.m_text.push_back(0);
+			}
+			result.m_entries.push_back(entry);
+		}
+		return result;
+	}
+
+
+	void SetDemangleCacheSize(size_t entries)
+	{
+		GetDemangleCache().SetCapacity(entries);
+	}
+
+
+	void ClearDemangleCache()
+	{
+		GetDemangleCache().Clear();
+	}
+
+
 	bool IsGNU3MangledString(const std::string& mangledName)
 	{
 		return BNIsGNU3MangledString(mangledName.c_str());
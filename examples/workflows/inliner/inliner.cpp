@@ -6,7 +6,7 @@
 #include <mutex>
 #include <string>
 #include <tuple>
-#include <unordered_map>
+#include <set>
 
 #include "binaryninjaapi.h"
 #include "lowlevelilinstruction.h"
@@ -25,26 +25,27 @@ extern "C"
 {
 	BN_DECLARE_CORE_ABI_VERSION
 
-	// TODO: Replace with analysis cache opaque datastore.
-	std::mutex g_mutex;
-	unordered_map<void*, unordered_map<uint64_t, set<uint64_t>>> g_callSiteInlines;
+	struct CallSiteInlines
+	{
+		std::mutex mutex;
+		set<uint64_t> addresses;
+	};
+	AnalysisDataSlot<CallSiteInlines> g_callSiteInlines;
 
 	void FunctionInliner(Ref<AnalysisContext> analysisContext)
 	{
-		std::unique_lock<std::mutex> lock(g_mutex);
-
-		Ref<Function> function = analysisContext->GetFunction();
-		Ref<BinaryView> data = function->GetView();
-		auto gItr = g_callSiteInlines.find(data->GetObject());
-		if (gItr == g_callSiteInlines.end())
+		auto inlines = g_callSiteInlines.Get(analysisContext);
+		if (!inlines)
 			return;
 
-		auto itr = gItr->second.find(function->GetStart());
-		if (itr == gItr->second.end())
-			return;
+		set<uint64_t> callSiteInlines;
+		{
+			std::lock_guard<std::mutex> lock(inlines->mutex);
+			callSiteInlines = inlines->addresses;
+		}
 
-		auto& callSiteInlines = itr->second;
-		lock.unlock();
+		Ref<Function> function = analysisContext->GetFunction();
+		Ref<BinaryView> data = function->GetView();
 
 		bool updated = false;
 		uint8_t opcode[BN_MAX_INSTRUCTION_LENGTH];
@@ -152,8 +153,11 @@ extern "C"
 		    [](BinaryView* view, Function* func) {
 			    // TODO func->Inform("inlinedCallSites")
 			    // TODO resolve multiple embedded inlines
-			    std::lock_guard<std::mutex> lock(g_mutex);
-			    g_callSiteInlines[view->GetObject()][func->GetStart()].insert(view->GetCurrentOffset());
+			    auto inlines = g_callSiteInlines.GetOrCreate(func);
+			    {
+				    std::lock_guard<std::mutex> lock(inlines->mutex);
+				    inlines->addresses.insert(view->GetCurrentOffset());
+			    }
 			    func->Reanalyze();
 		    },
 		    inlinerIsValid);
@@ -18,6 +18,13 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 
+#include <cstring>
+#ifndef WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 #include "binaryninjaapi.h"
 
 using namespace BinaryNinja;
@@ -76,3 +83,139 @@ size_t CoreFileAccessor::Write(uint64_t offset, const void* src, size_t len)
 {
 	return m_callbacks.write(m_callbacks.context, offset, src, len);
 }
+
+
+#ifdef WIN32
+MmapFileAccessor::MmapFileAccessor(const string& path, MmapAccessPattern pattern) :
+    m_data(nullptr), m_length(0), m_valid(false), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+{
+	// Windows only takes an access pattern hint when the file is opened
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if (pattern == SequentialMmapAccess)
+		flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	else if (pattern == RandomMmapAccess)
+		flags |= FILE_FLAG_RANDOM_ACCESS;
+
+	int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+	if (wideLength <= 0)
+		return;
+	wstring widePath(wideLength, L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength);
+
+	m_file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size))
+		return;
+	m_length = (uint64_t)size.QuadPart;
+	if (m_length == 0)
+	{
+		m_valid = true;
+		return;
+	}
+
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_mapping)
+		return;
+	m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	m_valid = m_data != nullptr;
+}
+
+
+MmapFileAccessor::~MmapFileAccessor()
+{
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+}
+
+
+void MmapFileAccessor::SetAccessPattern(MmapAccessPattern)
+{
+}
+#else
+static int GetMadviseForAccessPattern(MmapAccessPattern pattern)
+{
+	switch (pattern)
+	{
+		case SequentialMmapAccess:
+			return MADV_SEQUENTIAL;
+		case RandomMmapAccess:
+			return MADV_RANDOM;
+		default:
+			return MADV_NORMAL;
+	}
+}
+
+
+MmapFileAccessor::MmapFileAccessor(const string& path, MmapAccessPattern pattern) :
+    m_data(nullptr), m_length(0), m_valid(false), m_fd(-1)
+{
+	m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (m_fd < 0)
+		return;
+
+	struct stat st;
+	if (fstat(m_fd, &st) != 0)
+		return;
+	m_length = (uint64_t)st.st_size;
+	if (m_length == 0)
+	{
+		m_valid = true;
+		return;
+	}
+
+	void* data = mmap(nullptr, (size_t)m_length, PROT_READ, MAP_PRIVATE, m_fd, 0);
+	if (data == MAP_FAILED)
+		return;
+	m_data = (const uint8_t*)data;
+	m_valid = true;
+	SetAccessPattern(pattern);
+}
+
+
+MmapFileAccessor::~MmapFileAccessor()
+{
+	if (m_data)
+		munmap((void*)m_data, (size_t)m_length);
+	if (m_fd >= 0)
+		close(m_fd);
+}
+
+
+void MmapFileAccessor::SetAccessPattern(MmapAccessPattern pattern)
+{
+	if (m_data)
+		madvise((void*)m_data, (size_t)m_length, GetMadviseForAccessPattern(pattern));
+}
+#endif
+
+
+DataBufferView MmapFileAccessor::GetRange(uint64_t offset, size_t len) const
+{
+	if (offset >= m_length)
+		return DataBufferView();
+	return DataBufferView(m_data + offset, (size_t)min<uint64_t>(len, m_length - offset));
+}
+
+
+size_t MmapFileAccessor::Read(void* dest, uint64_t offset, size_t len)
+{
+	DataBufferView range = GetRange(offset, len);
+	if (range.IsEmpty())
+		return 0;
+	memcpy(dest, range.GetData(), range.GetLength());
+	return range.GetLength();
+}
+
+
+size_t MmapFileAccessor::Write(uint64_t, const void*, size_t)
+{
+	return 0;
+}
+
@@ -267,6 +267,12 @@ vector<Ref<BasicBlock>> Function::GetBasicBlocks() const
 }
 
 
+DominatorTree Function::GetDominatorTree(bool post) const
+{
+	return DominatorTree(GetBasicBlocks(), post);
+}
+
+
 Ref<BasicBlock> Function::GetBasicBlockAtAddress(Architecture* arch, uint64_t addr) const
 {
 	BNBasicBlock* block = BNGetFunctionBasicBlockAtAddress(m_object, arch->GetObject(), addr);
@@ -37,7 +37,41 @@ using namespace std;
 #endif
 
 
-unordered_map<HighLevelILOperandUsage, HighLevelILOperandType> HighLevelILInstructionBase::operandTypeForUsage = {
+static constexpr size_t HighLevelILOperationCount = (size_t)HLIL_MEM_PHI + 1;
+static constexpr size_t HighLevelILOperandUsageCount = (size_t)DestMemoryVersionHighLevelOperandUsage + 1;
+
+
+struct HighLevelILOperandTypeEntry
+{
+	HighLevelILOperandUsage usage;
+	HighLevelILOperandType type;
+};
+
+
+struct HighLevelILOperationUsageEntry
+{
+	BNHighLevelILOperation operation;
+	size_t count = 0;
+	HighLevelILOperandUsage usages[HighLevelILOperationOperands::MaxOperandUsages] = {};
+
+	constexpr HighLevelILOperationUsageEntry(
+	    BNHighLevelILOperation op, std::initializer_list<HighLevelILOperandUsage> list) :
+	    operation(op)
+	{
+		for (auto usage : list)
+			usages[count++] = usage;
+	}
+};
+
+
+struct HighLevelILOperandTables
+{
+	HighLevelILOperandType operandTypeForUsage[HighLevelILOperandUsageCount];
+	HighLevelILOperationOperands operationOperands[HighLevelILOperationCount];
+};
+
+
+static constexpr HighLevelILOperandTypeEntry s_operandTypeForUsage[] = {
     {SourceExprHighLevelOperandUsage, ExprHighLevelOperand},
     {VariableHighLevelOperandUsage, VariableHighLevelOperand},
     {DestVariableHighLevelOperandUsage, VariableHighLevelOperand},
@@ -77,8 +111,8 @@ unordered_map<HighLevelILOperandUsage, HighLevelILOperandType> HighLevelILInstru
     {DestMemoryVersionHighLevelOperandUsage, IndexHighLevelOperand}};
 
 
-unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>>
-    HighLevelILInstructionBase::operationOperandUsage = {{HLIL_NOP, {}}, {HLIL_BREAK, {}}, {HLIL_CONTINUE, {}},
+static constexpr HighLevelILOperationUsageEntry s_operationOperandUsage[] =
+    {{HLIL_NOP, {}}, {HLIL_BREAK, {}}, {HLIL_CONTINUE, {}},
         {HLIL_NORET, {}}, {HLIL_BP, {}}, {HLIL_UNDEF, {}}, {HLIL_UNIMPL, {}}, {HLIL_UNREACHABLE, {}},
         {HLIL_BLOCK, {BlockExprsHighLevelOperandUsage}},
         {HLIL_IF, {ConditionExprHighLevelOperandUsage, TrueExprHighLevelOperandUsage, FalseExprHighLevelOperandUsage}},
@@ -199,20 +233,25 @@ unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>>
         {HLIL_FCMP_UO, {LeftExprHighLevelOperandUsage, RightExprHighLevelOperandUsage}}};
 
 
-static unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsage, size_t>>
-    GetOperandIndexForOperandUsages()
+static constexpr HighLevelILOperandTables GetOperandTables()
 {
-	unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsage, size_t>> result;
-	result.reserve(HighLevelILInstructionBase::operationOperandUsage.size());
-	for (auto& operation : HighLevelILInstructionBase::operationOperandUsage)
+	HighLevelILOperandTables result = {};
+	for (auto& entry : s_operandTypeForUsage)
+		result.operandTypeForUsage[entry.usage] = entry.type;
+
+	for (auto& operation : s_operationOperandUsage)
 	{
-		result[operation.first] = unordered_map<HighLevelILOperandUsage, size_t>();
-		result[operation.first].reserve(operation.second.size());
+		HighLevelILOperationOperands& operands = result.operationOperands[operation.operation];
+		operands.valid = true;
+		operands.count = (uint8_t)operation.count;
+
 		size_t operand = 0;
-		for (auto usage : operation.second)
+		for (size_t i = 0; i < operation.count; i++)
 		{
-			result[operation.first][usage] = operand;
-			switch (HighLevelILInstructionBase::operandTypeForUsage[usage])
+			HighLevelILOperandUsage usage = operation.usages[i];
+			operands.usages[i] = usage;
+			operands.operandIndex[i] = (uint8_t)operand;
+			switch (result.operandTypeForUsage[usage])
 			{
 			case SSAVariableHighLevelOperand:
 			case SSAVariableListHighLevelOperand:
@@ -231,8 +270,25 @@ static unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsa
 }
 
 
-unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsage, size_t>>
-    HighLevelILInstructionBase::operationOperandIndex = GetOperandIndexForOperandUsages();
+static constexpr HighLevelILOperandTables s_operandTables = GetOperandTables();
+
+
+bool HighLevelILInstructionBase::GetOperandTypeForUsage(HighLevelILOperandUsage usage, HighLevelILOperandType& type)
+{
+	if ((size_t)usage >= HighLevelILOperandUsageCount)
+		return false;
+	type = s_operandTables.operandTypeForUsage[usage];
+	return true;
+}
+
+
+const HighLevelILOperationOperands* HighLevelILInstructionBase::GetOperationOperands(BNHighLevelILOperation operation)
+{
+	if ((size_t)operation >= HighLevelILOperationCount)
+		return nullptr;
+	const HighLevelILOperationOperands& operands = s_operandTables.operationOperands[operation];
+	return operands.valid ? &operands : nullptr;
+}
 
 
 bool HighLevelILIntegerList::ListIterator::operator==(const ListIterator& a) const
@@ -509,10 +565,8 @@ HighLevelILOperand::HighLevelILOperand(
     m_instr(instr),
     m_usage(usage), m_operandIndex(operandIndex)
 {
-	auto i = HighLevelILInstructionBase::operandTypeForUsage.find(m_usage);
-	if (i == HighLevelILInstructionBase::operandTypeForUsage.end())
+	if (!HighLevelILInstructionBase::GetOperandTypeForUsage(m_usage, m_type))
 		throw HighLevelILInstructionAccessException();
-	m_type = i->second;
 }
 
 
@@ -598,19 +652,13 @@ HighLevelILIndexList HighLevelILOperand::GetIndexList() const
 
 const HighLevelILOperand HighLevelILOperandList::ListIterator::operator*()
 {
-	HighLevelILOperandUsage usage = *pos;
-	auto i = owner->m_operandIndexMap.find(usage);
-	if (i == owner->m_operandIndexMap.end())
-		throw HighLevelILInstructionAccessException();
-	return HighLevelILOperand(owner->m_instr, usage, i->second);
+	return HighLevelILOperand(owner->m_instr, owner->m_operands.usages[pos], owner->m_operands.operandIndex[pos]);
 }
 
 
-HighLevelILOperandList::HighLevelILOperandList(const HighLevelILInstruction& instr,
-    const vector<HighLevelILOperandUsage>& usageList,
-    const unordered_map<HighLevelILOperandUsage, size_t>& operandIndexMap) :
-    m_instr(instr),
-    m_usageList(usageList), m_operandIndexMap(operandIndexMap)
+HighLevelILOperandList::HighLevelILOperandList(
+    const HighLevelILInstruction& instr, const HighLevelILOperationOperands& operands) :
+    m_instr(instr), m_operands(operands)
 {}
 
 
@@ -618,7 +666,7 @@ HighLevelILOperandList::const_iterator HighLevelILOperandList::begin() const
 {
 	const_iterator result;
 	result.owner = this;
-	result.pos = m_usageList.begin();
+	result.pos = 0;
 	return result;
 }
 
@@ -627,24 +675,22 @@ HighLevelILOperandList::const_iterator HighLevelILOperandList::end() const
 {
 	const_iterator result;
 	result.owner = this;
-	result.pos = m_usageList.end();
+	result.pos = m_operands.count;
 	return result;
 }
 
 
 size_t HighLevelILOperandList::size() const
 {
-	return m_usageList.size();
+	return m_operands.count;
 }
 
 
 const HighLevelILOperand HighLevelILOperandList::operator[](size_t i) const
 {
-	HighLevelILOperandUsage usage = m_usageList[i];
-	auto indexMap = m_operandIndexMap.find(usage);
-	if (indexMap == m_operandIndexMap.end())
+	if (i >= m_operands.count)
 		throw HighLevelILInstructionAccessException();
-	return HighLevelILOperand(m_instr, usage, indexMap->second);
+	return HighLevelILOperand(m_instr, m_operands.usages[i], m_operands.operandIndex[i]);
 }
 
 
@@ -713,13 +759,10 @@ HighLevelILInstruction::HighLevelILInstruction(const HighLevelILInstructionBase&
 
 HighLevelILOperandList HighLevelILInstructionBase::GetOperands() const
 {
-	auto usage = operationOperandUsage.find(operation);
-	if (usage == operationOperandUsage.end())
+	const HighLevelILOperationOperands* operands = GetOperationOperands(operation);
+	if (!operands)
 		throw HighLevelILInstructionAccessException();
-	auto operandIndex = operationOperandIndex.find(operation);
-	if (operandIndex == operationOperandIndex.end())
-		throw HighLevelILInstructionAccessException();
-	return HighLevelILOperandList(*(const HighLevelILInstruction*)this, usage->second, operandIndex->second);
+	return HighLevelILOperandList(*(const HighLevelILInstruction*)this, *operands);
 }
 
 
@@ -1340,6 +1383,77 @@ void HighLevelILInstruction::VisitExprs(const std::function<bool(const HighLevel
 }
 
 
+#ifndef BINARYNINJACORE_LIBRARY
+static void AppendHighLevelILExprForWalk(
+    HighLevelILFunction* func, size_t expr, bool ast, vector<HighLevelILExprVisitEntry>& stack)
+{
+	stack.push_back({ast ? func->GetRawExpr(expr) : func->GetRawNonASTExpr(expr), expr, false});
+}
+
+
+static bool IsHighLevelILASTOnlyOperand(BNHighLevelILOperation operation, HighLevelILOperandUsage usage)
+{
+	// Bodies of control flow structures are only part of the expression tree in AST form, matching
+	// CollectSubExprs
+	switch (usage)
+	{
+	case LoopExprHighLevelOperandUsage:
+	case DefaultExprHighLevelOperandUsage:
+	case CasesHighLevelOperandUsage:
+		return true;
+	case TrueExprHighLevelOperandUsage:
+	case FalseExprHighLevelOperandUsage:
+		return operation == HLIL_IF;
+	default:
+		return false;
+	}
+}
+
+
+void HighLevelILInstruction::AppendOperandExprsForWalk(HighLevelILFunction* func,
+    const BNHighLevelILInstruction& instr, bool ast, vector<HighLevelILExprVisitEntry>& stack)
+{
+	const HighLevelILOperationOperands* operands = GetOperationOperands(instr.operation);
+	if (!operands)
+		return;
+
+	for (size_t i = 0; i < operands->count; i++)
+	{
+		HighLevelILOperandUsage usage = operands->usages[i];
+		HighLevelILOperandType type;
+		if (!GetOperandTypeForUsage(usage, type))
+			continue;
+		if (!ast && IsHighLevelILASTOnlyOperand(instr.operation, usage))
+			continue;
+
+		size_t operand = operands->operandIndex[i];
+		if (type == ExprHighLevelOperand)
+		{
+			AppendHighLevelILExprForWalk(func, (size_t)instr.operands[operand], ast, stack);
+		}
+		else if (type == ExprListHighLevelOperand)
+		{
+			// Lists are a count followed by the first list node. Each list node holds four entries followed by the
+			// index of the next node.
+			size_t count = (size_t)instr.operands[operand];
+			if (count == 0)
+				continue;
+			BNHighLevelILInstruction node = func->GetRawExpr((size_t)instr.operands[operand + 1]);
+			for (size_t j = 0, k = 0; j < count; j++, k++)
+			{
+				if (k == 4)
+				{
+					node = func->GetRawExpr((size_t)node.operands[4]);
+					k = 0;
+				}
+				AppendHighLevelILExprForWalk(func, (size_t)node.operands[k], ast, stack);
+			}
+		}
+	}
+}
+#endif
+
+
 ExprId HighLevelILInstruction::CopyTo(HighLevelILFunction* dest) const
 {
 	return CopyTo(dest, [&](const HighLevelILInstruction& subExpr) { return subExpr.CopyTo(dest); });
@@ -2135,14 +2249,10 @@ bool HighLevelILInstruction::operator!=(const HighLevelILInstruction& other) con
 
 bool HighLevelILInstruction::GetOperandIndexForUsage(HighLevelILOperandUsage usage, size_t& operandIndex) const
 {
-	auto operationIter = HighLevelILInstructionBase::operationOperandIndex.find(operation);
-	if (operationIter == HighLevelILInstructionBase::operationOperandIndex.end())
-		return false;
-	auto usageIter = operationIter->second.find(usage);
-	if (usageIter == operationIter->second.end())
+	const HighLevelILOperationOperands* operands = GetOperationOperands(operation);
+	if (!operands)
 		return false;
-	operandIndex = usageIter->second;
-	return true;
+	return operands->GetOperandIndexForUsage(usage, operandIndex);
 }
 
 
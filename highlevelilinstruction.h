@@ -173,6 +173,10 @@ namespace BinaryNinja
 		HighLevelILInstructionAccessException() : ExceptionWithStackTrace("invalid access to HLIL instruction") {}
 	};
 
+#ifndef BINARYNINJACORE_LIBRARY
+	typedef ILExprVisitEntry<BNHighLevelILInstruction> HighLevelILExprVisitEntry;
+#endif
+
 	/*!
 		\ingroup highlevelil
 	*/
@@ -319,6 +323,34 @@ namespace BinaryNinja
 		operator _STD_VECTOR<SSAVariable>() const;
 	};
 
+	/*! Operand layout of a single HLIL operation: the operand usages in order and the raw operand slot that
+		each of them starts at.
+
+		\ingroup highlevelil
+	*/
+	struct HighLevelILOperationOperands
+	{
+		static constexpr size_t MaxOperandUsages = 6;
+
+		bool valid;
+		uint8_t count;
+		HighLevelILOperandUsage usages[MaxOperandUsages];
+		uint8_t operandIndex[MaxOperandUsages];
+
+		bool GetOperandIndexForUsage(HighLevelILOperandUsage usage, size_t& operand) const
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				if (usages[i] == usage)
+				{
+					operand = operandIndex[i];
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
 	/*!
 		\ingroup highlevelil
 	*/
@@ -332,10 +364,8 @@ namespace BinaryNinja
 		size_t exprIndex, instructionIndex;
 		bool ast;
 
-		static _STD_UNORDERED_MAP<HighLevelILOperandUsage, HighLevelILOperandType> operandTypeForUsage;
-		static _STD_UNORDERED_MAP<BNHighLevelILOperation, _STD_VECTOR<HighLevelILOperandUsage>> operationOperandUsage;
-		static _STD_UNORDERED_MAP<BNHighLevelILOperation, _STD_UNORDERED_MAP<HighLevelILOperandUsage, size_t>>
-		    operationOperandIndex;
+		static bool GetOperandTypeForUsage(HighLevelILOperandUsage usage, HighLevelILOperandType& type);
+		static const HighLevelILOperationOperands* GetOperationOperands(BNHighLevelILOperation operation);
 
 		HighLevelILOperandList GetOperands() const;
 
@@ -446,6 +476,40 @@ namespace BinaryNinja
 		void VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& preFunc,
 			const std::function<void(const HighLevelILInstruction& expr)>& postFunc) const;
 
+#ifndef BINARYNINJACORE_LIBRARY
+		/*! Walk this expression and its sub-expressions with an explicit stack instead of recursion.
+
+			The callback receives the index and raw instruction of each expression, no HighLevelILInstruction objects are
+			constructed during the walk. Operands are visited in operand order.
+
+			\param func Callable taking <tt>(size_t exprIndex, const BNHighLevelILInstruction& instr)</tt> and returning
+				an ILVisitAction, a bool (false skips the operands of the expression) or nothing
+			\param stack Scratch stack, pass the same vector to repeated walks to reuse its storage
+			\param order Whether expressions are visited before or after their operands
+			\return false if the walk was stopped by the callback
+		*/
+		template <typename F>
+		bool WalkExprs(
+		    F&& func, std::vector<HighLevelILExprVisitEntry>& stack, ILVisitOrder order = PreOrderILVisit) const
+		{
+			HighLevelILFunction* il = function;
+			return WalkILExprs<BNHighLevelILInstruction>(*this, exprIndex, func, stack, order,
+			    [il, ast = ast](const BNHighLevelILInstruction& instr, std::vector<HighLevelILExprVisitEntry>& children) {
+				    AppendOperandExprsForWalk(il, instr, ast, children);
+			    });
+		}
+
+		template <typename F>
+		bool WalkExprs(F&& func, ILVisitOrder order = PreOrderILVisit) const
+		{
+			std::vector<HighLevelILExprVisitEntry> stack;
+			return WalkExprs(func, stack, order);
+		}
+
+		static void AppendOperandExprsForWalk(HighLevelILFunction* func, const BNHighLevelILInstruction& instr, bool ast,
+		    std::vector<HighLevelILExprVisitEntry>& stack);
+#endif
+
 		ExprId CopyTo(HighLevelILFunction* dest) const;
 		ExprId CopyTo(HighLevelILFunction* dest,
 		    const std::function<ExprId(const HighLevelILInstruction& subExpr)>& subExprHandler) const;
@@ -801,7 +865,7 @@ namespace BinaryNinja
 		struct ListIterator
 		{
 			const HighLevelILOperandList* owner;
-			_STD_VECTOR<HighLevelILOperandUsage>::const_iterator pos;
+			size_t pos;
 			bool operator==(const ListIterator& a) const { return pos == a.pos; }
 			bool operator!=(const ListIterator& a) const { return pos != a.pos; }
 			bool operator<(const ListIterator& a) const { return pos < a.pos; }
@@ -814,15 +878,12 @@ namespace BinaryNinja
 		};
 
 		HighLevelILInstruction m_instr;
-		const _STD_VECTOR<HighLevelILOperandUsage>& m_usageList;
-		const _STD_UNORDERED_MAP<HighLevelILOperandUsage, size_t>& m_operandIndexMap;
+		const HighLevelILOperationOperands& m_operands;
 
 	  public:
 		typedef ListIterator const_iterator;
 
-		HighLevelILOperandList(const HighLevelILInstruction& instr,
-		    const _STD_VECTOR<HighLevelILOperandUsage>& usageList,
-		    const _STD_UNORDERED_MAP<HighLevelILOperandUsage, size_t>& operandIndexMap);
+		HighLevelILOperandList(const HighLevelILInstruction& instr, const HighLevelILOperationOperands& operands);
 
 		const_iterator begin() const;
 		const_iterator end() const;
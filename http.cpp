@@ -20,6 +20,9 @@
 
 #include <cstring>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <math.h>
 #include "http.h"
@@ -52,12 +55,23 @@ namespace BinaryNinja::Http
 		const Request& request;
 		Response& response;
 
+		// Body bytes delivered by all attempts, including those before this one
+		uint64_t* delivered = nullptr;
+		// Value of *delivered when this attempt started
+		uint64_t resumeOffset = 0;
+
 		RequestContext(const Request& request, Response& response) :
 		    uploadOffset(0), downloadLength(0), cancelled(false), request(request), response(response)
 		{}
 	};
 
 
+	static bool IsResumableMethod(const string& method)
+	{
+		return method == "GET" || method == "HEAD";
+	}
+
+
 	int64_t HttpReadCallback(uint8_t* data, uint64_t len, void* ctxt)
 	{
 		auto* request = reinterpret_cast<RequestContext*>(ctxt);
@@ -100,8 +114,20 @@ namespace BinaryNinja::Http
 	uint64_t HttpWriteCallback(uint8_t* data, uint64_t len, void* ctxt)
 	{
 		auto* request = reinterpret_cast<RequestContext*>(ctxt);
-		// copy can totally take pointers, pretty cool
-		copy(data, &data[len], back_inserter(request->response.body));
+		if (request->request.m_bodySink)
+		{
+			if (!request->request.m_bodySink(data, len))
+			{
+				request->cancelled = true;
+				return 0;
+			}
+		}
+		else
+		{
+			// copy can totally take pointers, pretty cool
+			copy(data, &data[len], back_inserter(request->response.body));
+		}
+		*request->delivered += len;
 
 		// Detect content length if it has not been found yet
 		if (request->downloadLength == 0)
@@ -110,8 +136,9 @@ namespace BinaryNinja::Http
 			auto found = headers.find("Content-Length");
 			if (found != headers.end())
 			{
-				request->downloadLength = strtoll(found->second.c_str(), nullptr, 10);
-				request->response.body.reserve(request->downloadLength);
+				request->downloadLength = request->resumeOffset + strtoll(found->second.c_str(), nullptr, 10);
+				if (!request->request.m_bodySink)
+					request->response.body.reserve(request->downloadLength);
 			}
 			else
 			{
@@ -121,7 +148,7 @@ namespace BinaryNinja::Http
 
 		if (request->request.m_downloadProgress)
 		{
-			if (!request->request.m_downloadProgress(request->response.body.size(), request->downloadLength))
+			if (!request->request.m_downloadProgress(*request->delivered, request->downloadLength))
 			{
 				// Signal error by returning non-len
 				request->cancelled = true;
@@ -362,21 +389,70 @@ namespace BinaryNinja::Http
 	}
 
 
+	Request& Request::SetBodySink(std::function<bool(const uint8_t*, size_t)> sink)
+	{
+		m_bodySink = std::move(sink);
+		return *this;
+	}
+
+
+	Request& Request::SetBodySink(FILE* file)
+	{
+		m_bodySink = [file](const uint8_t* data, size_t len) { return fwrite(data, 1, len, file) == len; };
+		return *this;
+	}
+
+
+#ifndef BINARYNINJACORE_LIBRARY
+	Request& Request::SetBodySink(DataBuffer& buffer)
+	{
+		m_bodySink = [&buffer](const uint8_t* data, size_t len) {
+			buffer.Append(data, len);
+			return true;
+		};
+		return *this;
+	}
+#endif
+
+
+	Request& Request::SetRange(uint64_t start, std::optional<uint64_t> end)
+	{
+		m_rangeStart = start;
+		m_rangeEnd = end;
+		return *this;
+	}
+
+
 	int Perform(const Ref<DownloadInstance>& instance, const Request& request, Response& response)
 	{
 		int result = -1;
 		int retry = 0;
+		uint64_t delivered = 0;
 		while (true)
 		{
 			response.response.statusCode = 0;
 			response.response.headers.clear();
-			response.body.clear();
 			response.error.clear();
 
+			// After a failed transfer, ask for the rest of the body instead of starting over
+			bool resuming = delivered > 0;
+			if (!resuming)
+				response.body.clear();
+
+			unordered_map<string, string> headers = request.m_headers;
+			uint64_t requestedOffset = request.m_rangeStart + delivered;
+			if (requestedOffset > 0 || request.m_rangeEnd)
+			{
+				string range = "bytes=" + to_string(requestedOffset) + "-";
+				if (request.m_rangeEnd)
+					range += to_string(*request.m_rangeEnd);
+				headers["Range"] = range;
+			}
+
 			if (getenv("BN_DEBUG_HTTP"))
 			{
 				LogDebug("> %s %s", request.m_method.c_str(), request.m_url.c_str());
-				for (auto& header : request.m_headers)
+				for (auto& header : headers)
 				{
 					LogDebug("> %s: %s", header.first.c_str(), header.second.c_str());
 				}
@@ -391,6 +467,8 @@ namespace BinaryNinja::Http
 			}
 
 			RequestContext context {request, response};
+			context.delivered = &delivered;
+			context.resumeOffset = delivered;
 			BNDownloadInstanceInputOutputCallbacks callbacks {};
 			memset(&callbacks, 0, sizeof(BNDownloadInstanceInputOutputCallbacks));
 			callbacks.readContext = &context;
@@ -398,11 +476,23 @@ namespace BinaryNinja::Http
 			callbacks.writeContext = &context;
 			callbacks.writeCallback = &HttpWriteCallback;
 			result = instance->PerformCustomRequest(
-			    request.m_method, request.m_url, request.m_headers, response.response, &callbacks);
+			    request.m_method, request.m_url, headers, response.response, &callbacks);
 			if (getenv("BN_DEBUG_HTTP"))
 			{
 				LogDebug("* Function returned: %d", result);
 			}
+			if (result >= 0 && resuming && response.response.statusCode != PartialContent)
+			{
+				// The server ignored the Range header and sent the whole resource again
+				if (request.m_bodySink)
+				{
+					response.error = "Server does not support resuming the transfer";
+					result = -1;
+					break;
+				}
+				response.body.erase(response.body.begin(), response.body.begin() + context.resumeOffset);
+				delivered -= context.resumeOffset;
+			}
 			if (result >= 0)
 				break;
 
@@ -415,6 +505,13 @@ namespace BinaryNinja::Http
 			response.error = instance->GetError();
 			if (retry == HTTP_MAX_RETRIES || context.cancelled)
 				break;
+			if (delivered > 0 && !IsResumableMethod(request.m_method))
+			{
+				// Bytes already handed to a sink cannot be taken back, so only a buffered body can restart
+				if (request.m_bodySink)
+					break;
+				delivered = 0;
+			}
 			size_t backoff = 1000 * HTTP_BACKOFF_FACTOR * (2 * pow(2, retry - 1));
 			retry += 1;
 			LogWarn("Attempt %d to %s %s failed, trying again in %zums\n", retry, request.m_method.data(),
@@ -442,9 +539,197 @@ namespace BinaryNinja::Http
 			}
 		}
 
+		response.bytesReceived = delivered;
+		return result;
+	}
+
+	struct Client::State
+	{
+		struct Pending
+		{
+			Request request;
+			string host;
+			std::promise<ClientResult> promise;
+			std::chrono::steady_clock::time_point enqueued;
+		};
+
+		Ref<DownloadProvider> provider;
+		size_t maxConcurrent;
+		size_t maxPerHost;
+
+		mutable std::mutex mutex;
+		std::condition_variable workAvailable;
+		std::condition_variable allDone;
+		std::deque<Pending> queue;
+		unordered_map<string, size_t> hostInFlight;
+		vector<Ref<DownloadInstance>> idleInstances;
+		vector<std::thread> threads;
+		size_t idleThreads = 0;
+		size_t active = 0;
+		bool stopping = false;
+
+		std::deque<Pending>::iterator NextRunnable()
+		{
+			for (auto i = queue.begin(); i != queue.end(); ++i)
+			{
+				auto found = hostInFlight.find(i->host);
+				if (found == hostInFlight.end() || found->second < maxPerHost)
+					return i;
+			}
+			return queue.end();
+		}
+
+		void WorkerThread()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true)
+			{
+				auto next = queue.end();
+				idleThreads++;
+				workAvailable.wait(lock, [&]() {
+					next = NextRunnable();
+					return next != queue.end() || (stopping && queue.empty());
+				});
+				idleThreads--;
+				if (next == queue.end())
+					return;
+
+				Pending pending = std::move(*next);
+				queue.erase(next);
+				hostInFlight[pending.host]++;
+				active++;
+
+				Ref<DownloadInstance> instance;
+				if (!idleInstances.empty())
+				{
+					instance = idleInstances.back();
+					idleInstances.pop_back();
+				}
+				lock.unlock();
+
+				auto started = std::chrono::steady_clock::now();
+				ClientResult result;
+				result.timings.queued =
+				    std::chrono::duration_cast<std::chrono::microseconds>(started - pending.enqueued);
+				try
+				{
+					if (!instance)
+						instance = provider->CreateNewInstance();
+					if (instance)
+						result.result = Perform(instance, pending.request, result.response);
+					else
+						result.response.error = "Could not create download instance";
+					result.timings.performed = std::chrono::duration_cast<std::chrono::microseconds>(
+					    std::chrono::steady_clock::now() - started);
+					pending.promise.set_value(std::move(result));
+				}
+				catch (...)
+				{
+					pending.promise.set_exception(std::current_exception());
+				}
+
+				lock.lock();
+				if (instance)
+					idleInstances.push_back(instance);
+				if (--hostInFlight[pending.host] == 0)
+					hostInFlight.erase(pending.host);
+				active--;
+				// A finished request may unblock one that was held back by its host limit
+				workAvailable.notify_all();
+				if (queue.empty() && active == 0)
+					allDone.notify_all();
+			}
+		}
+	};
+
+
+	Client::Client(Ref<DownloadProvider> provider, size_t maxConcurrent, size_t maxPerHost) :
+	    m_state(std::make_shared<State>())
+	{
+		m_state->provider = provider;
+		m_state->maxConcurrent = std::max<size_t>(maxConcurrent, 1);
+		m_state->maxPerHost = std::max<size_t>(maxPerHost, 1);
+	}
+
+
+	Client::~Client()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_state->mutex);
+			m_state->stopping = true;
+		}
+		m_state->workAvailable.notify_all();
+		for (auto& thread : m_state->threads)
+			thread.join();
+	}
+
+
+	std::future<ClientResult> Client::Enqueue(Request request)
+	{
+		string host = GetHost(request.m_url);
+		State::Pending pending {std::move(request), std::move(host), {}, std::chrono::steady_clock::now()};
+		std::future<ClientResult> result = pending.promise.get_future();
+
+		std::unique_lock<std::mutex> lock(m_state->mutex);
+		m_state->queue.push_back(std::move(pending));
+		// Threads are started on demand, up to the concurrency limit
+		if (m_state->idleThreads == 0 && m_state->threads.size() < m_state->maxConcurrent)
+		{
+			State* state = m_state.get();
+			m_state->threads.emplace_back([state]() { state->WorkerThread(); });
+		}
+		lock.unlock();
+		m_state->workAvailable.notify_one();
 		return result;
 	}
 
+
+	vector<ClientResult> Client::PerformAll(vector<Request> requests)
+	{
+		vector<std::future<ClientResult>> futures;
+		futures.reserve(requests.size());
+		for (auto& request : requests)
+			futures.push_back(Enqueue(std::move(request)));
+
+		vector<ClientResult> results;
+		results.reserve(futures.size());
+		for (auto& future : futures)
+			results.push_back(future.get());
+		return results;
+	}
+
+
+	void Client::Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_state->mutex);
+		m_state->allDone.wait(lock, [this]() { return m_state->queue.empty() && m_state->active == 0; });
+	}
+
+
+	size_t Client::GetPendingCount() const
+	{
+		std::unique_lock<std::mutex> lock(m_state->mutex);
+		return m_state->queue.size() + m_state->active;
+	}
+
+
+	string Client::GetHost(const string& url)
+	{
+		size_t start = url.find("://");
+		start = (start == string::npos) ? 0 : start + 3;
+		size_t end = url.find_first_of("/?#", start);
+		if (end == string::npos)
+			end = url.size();
+		size_t userInfo = url.rfind('@', end);
+		if (userInfo != string::npos && userInfo >= start)
+			start = userInfo + 1;
+		string host = url.substr(start, end - start);
+		for (auto& ch : host)
+			ch = (char)tolower((unsigned char)ch);
+		return host;
+	}
+
+
 	vector<uint8_t> Response::GetRaw() const noexcept { return body; }
 
 
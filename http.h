@@ -27,6 +27,10 @@
 #include <functional>
 #include <utility>
 #include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <future>
+#include <memory>
 
 #ifdef BINARYNINJACORE_LIBRARY
 	#include "downloadprovider.h"
@@ -107,6 +111,8 @@ namespace BinaryNinja::Http
 		DownloadInstance::Response response;
 		_STD_VECTOR<uint8_t> body;
 		_STD_STRING error;
+		/*! Number of body bytes delivered, either into \c body or to the request's body sink */
+		uint64_t bytesReceived = 0;
 
 		/*!
 		    Get response body as uint8_t vector
@@ -198,6 +204,45 @@ namespace BinaryNinja::Http
 		std::function<bool(size_t, size_t)> m_downloadProgress;
 		std::function<bool(size_t, size_t)> m_uploadProgress;
 
+		std::function<bool(const uint8_t*, size_t)> m_bodySink;
+		uint64_t m_rangeStart = 0;
+		std::optional<uint64_t> m_rangeEnd;
+
+		/*!
+		    Stream the response body to a callback as it arrives instead of buffering it in Response::body.
+		    The status code is only known once Perform returns, so check it before trusting the streamed data.
+		    If a GET transfer fails part way, retries ask for the remainder with a Range header so the sink
+		    never sees the same byte twice; the retry fails if the server does not honor the range.
+		    \param sink Function called with each received chunk, return false to cancel the request
+		    \return This request, for chaining
+		 */
+		Request& SetBodySink(std::function<bool(const uint8_t*, size_t)> sink);
+
+		/*!
+		    Stream the response body directly to an open file
+		    \param file File opened for binary writing, must outlive the request
+		    \return This request, for chaining
+		 */
+		Request& SetBodySink(FILE* file);
+
+#ifndef BINARYNINJACORE_LIBRARY
+		/*!
+		    Stream the response body into a DataBuffer
+		    \param buffer Buffer to append to, must outlive the request
+		    \return This request, for chaining
+		 */
+		Request& SetBodySink(DataBuffer& buffer);
+#endif
+
+		/*!
+		    Request only part of the resource with a Range header. Servers that honor the range reply
+		    with PartialContent, others reply with the whole resource.
+		    \param start Offset of the first byte to request
+		    \param end Offset of the last byte to request (inclusive), or unbounded if not given
+		    \return This request, for chaining
+		 */
+		Request& SetRange(uint64_t start, std::optional<uint64_t> end = std::nullopt);
+
 		/*!
 		    Construct an arbitrary HTTP request with an empty body
 		    \param method Request method eg GET
@@ -362,6 +407,88 @@ namespace BinaryNinja::Http
 	 */
 	int Perform(const Ref<DownloadInstance>& instance, const Request& request, Response& response);
 
+
+	/*!
+	    Timing information for a request performed by a Client
+	 */
+	struct RequestTimings
+	{
+		/*! Time spent waiting in the queue for a free connection slot */
+		std::chrono::microseconds queued {0};
+		/*! Time spent performing the request, including retries */
+		std::chrono::microseconds performed {0};
+	};
+
+
+	/*!
+	    Result of a request performed by a Client
+	 */
+	struct ClientResult
+	{
+		/*! Return value of Perform, zero or greater on success */
+		int result = -1;
+		Response response;
+		RequestTimings timings;
+	};
+
+
+	/*!
+	    Runs HTTP requests concurrently on a fixed set of threads, reusing DownloadInstance objects
+	    from one provider between requests. Requests are started in submission order, except that a
+	    request is held back while its host already has the maximum number of requests in flight.
+	 */
+	class Client
+	{
+		struct State;
+		std::shared_ptr<State> m_state;
+
+	  public:
+		/*!
+		    \param provider Provider used to create the pooled DownloadInstance objects
+		    \param maxConcurrent Maximum number of requests in flight at once
+		    \param maxPerHost Maximum number of requests in flight to a single host
+		 */
+		Client(Ref<DownloadProvider> provider, size_t maxConcurrent = 8, size_t maxPerHost = 4);
+		Client(const Client&) = delete;
+		Client& operator=(const Client&) = delete;
+
+		/*!
+		    Waits for outstanding requests to finish before returning
+		 */
+		~Client();
+
+		/*!
+		    Queue a request
+		    \param request Request to perform
+		    \return Future that receives the result once the request has finished
+		 */
+		std::future<ClientResult> Enqueue(Request request);
+
+		/*!
+		    Perform a set of requests concurrently and wait for all of them
+		    \param requests Requests to perform
+		    \return Results in the same order as the requests
+		 */
+		_STD_VECTOR<ClientResult> PerformAll(_STD_VECTOR<Request> requests);
+
+		/*!
+		    Block until every queued request has finished
+		 */
+		void Wait();
+
+		/*!
+		    Number of requests that are queued or in flight
+		 */
+		size_t GetPendingCount() const;
+
+		/*!
+		    Extract the host (and port, if given) that a URL refers to
+		    \param url Request URL eg https://binary.ninja:443/path
+		    \return Host name eg binary.ninja:443
+		 */
+		static _STD_STRING GetHost(const _STD_STRING& url);
+	};
+
 #undef _STD_VECTOR
 #undef _STD_SET
 #undef _STD_UNORDERED_MAP
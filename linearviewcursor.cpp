@@ -19,6 +19,8 @@
 // IN THE SOFTWARE.
 
 #include "binaryninjaapi.h"
+#include <condition_variable>
+#include <deque>
 
 using namespace std;
 using namespace BinaryNinja;
@@ -205,6 +207,20 @@ vector<LinearDisassemblyLine> LinearViewCursor::GetLines()
 }
 
 
+size_t LinearViewCursor::GetLines(vector<LinearDisassemblyLine>& result)
+{
+	size_t count;
+	BNLinearDisassemblyLine* lines = BNGetLinearViewCursorLines(m_object, &count);
+
+	result.reserve(result.size() + count);
+	for (size_t i = 0; i < count; i++)
+		result.push_back(LinearDisassemblyLine::FromAPIObject(&lines[i]));
+
+	BNFreeLinearDisassemblyLines(lines, count);
+	return count;
+}
+
+
 Ref<LinearViewCursor> LinearViewCursor::Duplicate()
 {
 	return new LinearViewCursor(BNDuplicateLinearViewCursor(m_object));
@@ -215,3 +231,214 @@ int LinearViewCursor::Compare(LinearViewCursor* a, LinearViewCursor* b)
 {
 	return BNCompareLinearViewCursors(a->GetObject(), b->GetObject());
 }
+
+
+struct LinearLineStream::State
+{
+	struct Segment
+	{
+		uint64_t start;
+		uint64_t end;
+		bool started = false;
+		bool done = false;
+		vector<LinearDisassemblyLine> lines;
+	};
+
+	Ref<LinearViewObject> root;
+	uint64_t start = 0;
+	uint64_t end = 0;
+	uint64_t segmentSize = 0;
+	size_t maxSegmentsInFlight = 0;
+
+	mutex stateMutex;
+	condition_variable segmentDone;
+	deque<shared_ptr<Segment>> segments;
+	uint64_t nextSegmentStart = 0;
+	uint64_t position = 0;
+	atomic<bool> cancelled {false};
+
+	// Segment currently being handed out by Next
+	vector<LinearDisassemblyLine> current;
+	size_t currentIndex = 0;
+
+	void Init(uint64_t requestedSegmentSize, size_t requestedInFlight)
+	{
+		nextSegmentStart = start;
+		position = start;
+		segmentSize = requestedSegmentSize;
+		if (segmentSize == 0)
+			segmentSize = max<uint64_t>(0x10000, (end - start) / 1024);
+		maxSegmentsInFlight = requestedInFlight;
+		if (maxSegmentsInFlight == 0)
+			maxSegmentsInFlight = max<size_t>(2, 2 * GetWorkerThreadCount());
+	}
+
+	// Claims a segment for rendering, fails if the reader or another job already took it
+	bool Claim(const shared_ptr<Segment>& segment)
+	{
+		unique_lock<mutex> lock(stateMutex);
+		if (segment->started)
+			return false;
+		segment->started = true;
+		return true;
+	}
+
+	static void Render(const shared_ptr<State>& state, const shared_ptr<Segment>& segment)
+	{
+		vector<LinearDisassemblyLine> lines;
+		if (!state->cancelled)
+		{
+			Ref<LinearViewCursor> cursor = new LinearViewCursor(state->root);
+			cursor->SeekToOrderingIndex(segment->start);
+			while (!state->cancelled && cursor->IsValid())
+			{
+				// An object belongs to the segment holding the start of its range, the cursor may have landed
+				// in the middle of one owned by the previous segment
+				BNAddressRange range = cursor->GetOrderingIndex();
+				if (range.start >= segment->end)
+					break;
+				if (range.start >= segment->start)
+					cursor->GetLines(lines);
+				if (!cursor->Next())
+					break;
+			}
+		}
+
+		unique_lock<mutex> lock(state->stateMutex);
+		segment->lines = std::move(lines);
+		segment->done = true;
+		state->segmentDone.notify_all();
+	}
+};
+
+
+LinearLineStream::LinearLineStream(LinearViewObject* root, uint64_t segmentSize, size_t maxSegmentsInFlight) :
+    m_state(make_shared<State>())
+{
+	m_state->root = root;
+	m_state->start = 0;
+	m_state->end = root->GetOrderingIndexTotal();
+	m_state->Init(segmentSize, maxSegmentsInFlight);
+	ScheduleSegments();
+}
+
+
+LinearLineStream::LinearLineStream(
+    LinearViewObject* root, const BNAddressRange& range, uint64_t segmentSize, size_t maxSegmentsInFlight) :
+    m_state(make_shared<State>())
+{
+	m_state->root = root;
+
+	Ref<LinearViewCursor> cursor = new LinearViewCursor(root);
+	cursor->SeekToAddress(range.start);
+	m_state->start = cursor->IsValid() ? cursor->GetOrderingIndex().start : root->GetOrderingIndexTotal();
+
+	// Objects that start before the end address are included in full
+	cursor->SeekToAddress(range.end);
+	if (cursor->IsValid())
+	{
+		BNAddressRange index = cursor->GetOrderingIndex();
+		Ref<LinearViewObject> object = cursor->GetCurrentObject();
+		m_state->end = (object && object->GetStart() < range.end) ? index.end : index.start;
+	}
+	else
+	{
+		m_state->end = root->GetOrderingIndexTotal();
+	}
+	m_state->end = max(m_state->end, m_state->start);
+
+	m_state->Init(segmentSize, maxSegmentsInFlight);
+	ScheduleSegments();
+}
+
+
+LinearLineStream::~LinearLineStream()
+{
+	// Queued segments hold their own reference to the state and finish immediately
+	m_state->cancelled = true;
+}
+
+
+void LinearLineStream::ScheduleSegments()
+{
+	vector<shared_ptr<State::Segment>> scheduled;
+	{
+		unique_lock<mutex> lock(m_state->stateMutex);
+		while (m_state->segments.size() < m_state->maxSegmentsInFlight && m_state->nextSegmentStart < m_state->end)
+		{
+			auto segment = make_shared<State::Segment>();
+			segment->start = m_state->nextSegmentStart;
+			segment->end = min(m_state->end, segment->start + m_state->segmentSize);
+			if (segment->end <= segment->start)
+				segment->end = m_state->end;
+			m_state->nextSegmentStart = segment->end;
+			m_state->segments.push_back(segment);
+			scheduled.push_back(segment);
+		}
+	}
+
+	for (auto& segment : scheduled)
+	{
+		shared_ptr<State> state = m_state;
+		WorkerEnqueue(
+		    [state, segment]() {
+			    if (state->Claim(segment))
+				    State::Render(state, segment);
+		    },
+		    "LinearLineStream");
+	}
+}
+
+
+bool LinearLineStream::NextBatch(vector<LinearDisassemblyLine>& lines)
+{
+	shared_ptr<State::Segment> segment;
+	{
+		unique_lock<mutex> lock(m_state->stateMutex);
+		if (m_state->segments.empty())
+			return false;
+		segment = m_state->segments.front();
+	}
+
+	// Render the segment here if no worker has picked it up yet, so a reader on a worker thread never waits on
+	// jobs queued behind it
+	if (m_state->Claim(segment))
+		State::Render(m_state, segment);
+
+	{
+		unique_lock<mutex> lock(m_state->stateMutex);
+		m_state->segmentDone.wait(lock, [&]() { return segment->done; });
+		m_state->segments.pop_front();
+		m_state->position = segment->end;
+		lines = std::move(segment->lines);
+	}
+	ScheduleSegments();
+	return true;
+}
+
+
+bool LinearLineStream::Next(LinearDisassemblyLine& line)
+{
+	while (m_state->currentIndex >= m_state->current.size())
+	{
+		m_state->current.clear();
+		m_state->currentIndex = 0;
+		if (!NextBatch(m_state->current))
+			return false;
+	}
+	line = std::move(m_state->current[m_state->currentIndex++]);
+	return true;
+}
+
+
+uint64_t LinearLineStream::GetPosition() const
+{
+	unique_lock<mutex> lock(m_state->stateMutex);
+	return m_state->position;
+}
+
+
+uint64_t LinearLineStream::GetEnd() const
+{
+	return m_state->end;
+}
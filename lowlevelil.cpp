@@ -581,6 +581,12 @@ size_t LowLevelILFunction::GetExprCount() const
 }
 
 
+LowLevelILFunctionSnapshot LowLevelILFunction::Snapshot()
+{
+	return LowLevelILFunctionSnapshot(this);
+}
+
+
 void LowLevelILFunction::UpdateInstructionOperand(size_t i, size_t operandIndex, ExprId value)
 {
 	BNUpdateLowLevelILOperand(m_object, i, operandIndex, value);
@@ -1023,3 +1029,56 @@ Ref<FlowGraph> LowLevelILFunction::CreateFunctionGraph(DisassemblySettings* sett
 	BNFlowGraph* graph = BNCreateLowLevelILFunctionGraph(m_object, settings ? settings->GetObject() : nullptr);
 	return new CoreFlowGraph(graph);
 }
+
+
+LowLevelILFunctionSnapshot::LowLevelILFunctionSnapshot(LowLevelILFunction* func) : m_function(func)
+{
+	BNLowLevelILFunction* object = func->GetObject();
+
+	size_t exprCount = BNGetLowLevelILExprCount(object);
+	m_operations.reserve(exprCount);
+	m_attributes.reserve(exprCount);
+	m_sizes.reserve(exprCount);
+	m_flags.reserve(exprCount);
+	m_sourceOperands.reserve(exprCount);
+	m_operands.reserve(exprCount * OperandsPerExpr);
+	m_addresses.reserve(exprCount);
+	for (size_t i = 0; i < exprCount; i++)
+	{
+		BNLowLevelILInstruction instr = BNGetLowLevelILByIndex(object, i);
+		m_operations.push_back(instr.operation);
+		m_attributes.push_back(instr.attributes);
+		m_sizes.push_back(instr.size);
+		m_flags.push_back(instr.flags);
+		m_sourceOperands.push_back(instr.sourceOperand);
+		m_operands.insert(m_operands.end(), instr.operands, instr.operands + OperandsPerExpr);
+		m_addresses.push_back(instr.address);
+	}
+
+	size_t instrCount = BNGetLowLevelILInstructionCount(object);
+	m_instructionExprs.reserve(instrCount);
+	for (size_t i = 0; i < instrCount; i++)
+		m_instructionExprs.push_back(BNGetLowLevelILIndexForInstruction(object, i));
+}
+
+
+BNLowLevelILInstruction LowLevelILSnapshotExpr::GetRawExpr() const
+{
+	BNLowLevelILInstruction instr;
+	instr.operation = GetOperation();
+	instr.attributes = GetAttributes();
+	instr.size = GetSize();
+	instr.flags = GetFlags();
+	instr.sourceOperand = GetSourceOperand();
+	for (size_t i = 0; i < LowLevelILFunctionSnapshot::OperandsPerExpr; i++)
+		instr.operands[i] = GetRawOperand(i);
+	instr.address = GetAddress();
+	return instr;
+}
+
+
+LowLevelILInstruction LowLevelILSnapshotExpr::ToInstruction() const
+{
+	LowLevelILFunction* func = m_snapshot->GetFunction();
+	return LowLevelILInstruction(func, GetRawExpr(), m_exprIndex, func->GetInstructionForExpr(m_exprIndex));
+}
@@ -36,7 +36,41 @@ using namespace std;
 #endif
 
 
-unordered_map<LowLevelILOperandUsage, LowLevelILOperandType> LowLevelILInstructionBase::operandTypeForUsage = {
+static constexpr size_t LowLevelILOperationCount = (size_t)LLIL_MEM_PHI + 1;
+static constexpr size_t LowLevelILOperandUsageCount = (size_t)OffsetLowLevelOperandUsage + 1;
+
+
+struct LowLevelILOperandTypeEntry
+{
+	LowLevelILOperandUsage usage;
+	LowLevelILOperandType type;
+};
+
+
+struct LowLevelILOperationUsageEntry
+{
+	BNLowLevelILOperation operation;
+	size_t count = 0;
+	LowLevelILOperandUsage usages[LowLevelILOperationOperands::MaxOperandUsages] = {};
+
+	constexpr LowLevelILOperationUsageEntry(
+	    BNLowLevelILOperation op, std::initializer_list<LowLevelILOperandUsage> list) :
+	    operation(op)
+	{
+		for (auto usage : list)
+			usages[count++] = usage;
+	}
+};
+
+
+struct LowLevelILOperandTables
+{
+	LowLevelILOperandType operandTypeForUsage[LowLevelILOperandUsageCount];
+	LowLevelILOperationOperands operationOperands[LowLevelILOperationCount];
+};
+
+
+static constexpr LowLevelILOperandTypeEntry s_operandTypeForUsage[] = {
     {SourceExprLowLevelOperandUsage, ExprLowLevelOperand},
     {SourceRegisterLowLevelOperandUsage, RegisterLowLevelOperand},
     {SourceRegisterStackLowLevelOperandUsage, RegisterStackLowLevelOperand},
@@ -80,10 +114,11 @@ unordered_map<LowLevelILOperandUsage, LowLevelILOperandType> LowLevelILInstructi
     {OutputSSARegisterOrFlagListLowLevelOperandUsage, SSARegisterOrFlagListLowLevelOperand},
     {SourceMemoryVersionsLowLevelOperandUsage, IndexListLowLevelOperand},
     {TargetsLowLevelOperandUsage, IndexMapLowLevelOperand},
-    {RegisterStackAdjustmentsLowLevelOperandUsage, RegisterStackAdjustmentsLowLevelOperand}};
+    {RegisterStackAdjustmentsLowLevelOperandUsage, RegisterStackAdjustmentsLowLevelOperand},
+    {OffsetLowLevelOperandUsage, IntegerLowLevelOperand}};
 
 
-unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>> LowLevelILInstructionBase::operationOperandUsage =
+static constexpr LowLevelILOperationUsageEntry s_operationOperandUsage[] =
     {{LLIL_NOP, {}}, {LLIL_POP, {}}, {LLIL_NORET, {}}, {LLIL_SYSCALL, {}}, {LLIL_BP, {}}, {LLIL_UNDEF, {}},
         {LLIL_UNIMPL, {}}, {LLIL_SET_REG, {DestRegisterLowLevelOperandUsage, SourceExprLowLevelOperandUsage}},
         {LLIL_SET_REG_SPLIT,
@@ -221,20 +256,24 @@ unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>> LowLevelILI
         {LLIL_FCMP_UO, {LeftExprLowLevelOperandUsage, RightExprLowLevelOperandUsage}}};
 
 
-static unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage, size_t>>
-    GetOperandIndexForOperandUsages()
+static constexpr LowLevelILOperandTables GetOperandTables()
 {
-	unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage, size_t>> result;
-	result.reserve(LowLevelILInstructionBase::operationOperandUsage.size());
-	for (auto& operation : LowLevelILInstructionBase::operationOperandUsage)
+	LowLevelILOperandTables result = {};
+	for (auto& entry : s_operandTypeForUsage)
+		result.operandTypeForUsage[entry.usage] = entry.type;
+
+	for (auto& operation : s_operationOperandUsage)
 	{
-		result[operation.first] = unordered_map<LowLevelILOperandUsage, size_t>();
+		LowLevelILOperationOperands& operands = result.operationOperands[operation.operation];
+		operands.valid = true;
+		operands.count = (uint8_t)operation.count;
 
 		size_t operand = 0;
-		result[operation.first].reserve(operation.second.size());
-		for (auto usage : operation.second)
+		for (size_t i = 0; i < operation.count; i++)
 		{
-			result[operation.first][usage] = operand;
+			LowLevelILOperandUsage usage = operation.usages[i];
+			operands.usages[i] = usage;
+			operands.operandIndex[i] = (uint8_t)operand;
 			switch (usage)
 			{
 			case HighSSARegisterLowLevelOperandUsage:
@@ -258,7 +297,7 @@ static unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage
 				// PartialSSARegisterStackSourceLowLevelOperandUsage follows at same operand
 				break;
 			default:
-				switch (LowLevelILInstructionBase::operandTypeForUsage[usage])
+				switch (result.operandTypeForUsage[usage])
 				{
 				case SSARegisterLowLevelOperand:
 				case SSARegisterStackLowLevelOperand:
@@ -286,8 +325,25 @@ static unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage
 }
 
 
-unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage, size_t>>
-    LowLevelILInstructionBase::operationOperandIndex = GetOperandIndexForOperandUsages();
+static constexpr LowLevelILOperandTables s_operandTables = GetOperandTables();
+
+
+bool LowLevelILInstructionBase::GetOperandTypeForUsage(LowLevelILOperandUsage usage, LowLevelILOperandType& type)
+{
+	if ((size_t)usage >= LowLevelILOperandUsageCount)
+		return false;
+	type = s_operandTables.operandTypeForUsage[usage];
+	return true;
+}
+
+
+const LowLevelILOperationOperands* LowLevelILInstructionBase::GetOperationOperands(BNLowLevelILOperation operation)
+{
+	if ((size_t)operation >= LowLevelILOperationCount)
+		return nullptr;
+	const LowLevelILOperationOperands& operands = s_operandTables.operationOperands[operation];
+	return operands.valid ? &operands : nullptr;
+}
 
 
 RegisterOrFlag::RegisterOrFlag() : isFlag(false), index(BN_INVALID_REGISTER) {}
@@ -1088,10 +1144,8 @@ LowLevelILOperand::LowLevelILOperand(
     m_instr(instr),
     m_usage(usage), m_operandIndex(operandIndex)
 {
-	auto i = LowLevelILInstructionBase::operandTypeForUsage.find(m_usage);
-	if (i == LowLevelILInstructionBase::operandTypeForUsage.end())
+	if (!LowLevelILInstructionBase::GetOperandTypeForUsage(m_usage, m_type))
 		throw LowLevelILInstructionAccessException();
-	m_type = i->second;
 }
 
 
@@ -1286,19 +1340,13 @@ map<uint32_t, int32_t> LowLevelILOperand::GetRegisterStackAdjustments() const
 
 const LowLevelILOperand LowLevelILOperandList::ListIterator::operator*()
 {
-	LowLevelILOperandUsage usage = *pos;
-	auto i = owner->m_operandIndexMap.find(usage);
-	if (i == owner->m_operandIndexMap.end())
-		throw LowLevelILInstructionAccessException();
-	return LowLevelILOperand(owner->m_instr, usage, i->second);
+	return LowLevelILOperand(owner->m_instr, owner->m_operands.usages[pos], owner->m_operands.operandIndex[pos]);
 }
 
 
-LowLevelILOperandList::LowLevelILOperandList(const LowLevelILInstruction& instr,
-    const vector<LowLevelILOperandUsage>& usageList,
-    const unordered_map<LowLevelILOperandUsage, size_t>& operandIndexMap) :
-    m_instr(instr),
-    m_usageList(usageList), m_operandIndexMap(operandIndexMap)
+LowLevelILOperandList::LowLevelILOperandList(
+    const LowLevelILInstruction& instr, const LowLevelILOperationOperands& operands) :
+    m_instr(instr), m_operands(operands)
 {}
 
 
@@ -1306,7 +1354,7 @@ LowLevelILOperandList::const_iterator LowLevelILOperandList::begin() const
 {
 	const_iterator result;
 	result.owner = this;
-	result.pos = m_usageList.begin();
+	result.pos = 0;
 	return result;
 }
 
@@ -1315,24 +1363,22 @@ LowLevelILOperandList::const_iterator LowLevelILOperandList::end() const
 {
 	const_iterator result;
 	result.owner = this;
-	result.pos = m_usageList.end();
+	result.pos = m_operands.count;
 	return result;
 }
 
 
 size_t LowLevelILOperandList::size() const
 {
-	return m_usageList.size();
+	return m_operands.count;
 }
 
 
 const LowLevelILOperand LowLevelILOperandList::operator[](size_t i) const
 {
-	LowLevelILOperandUsage usage = m_usageList[i];
-	auto indexMap = m_operandIndexMap.find(usage);
-	if (indexMap == m_operandIndexMap.end())
+	if (i >= m_operands.count)
 		throw LowLevelILInstructionAccessException();
-	return LowLevelILOperand(m_instr, usage, indexMap->second);
+	return LowLevelILOperand(m_instr, m_operands.usages[i], m_operands.operandIndex[i]);
 }
 
 
@@ -1398,13 +1444,10 @@ LowLevelILInstruction::LowLevelILInstruction(const LowLevelILInstructionBase& in
 
 LowLevelILOperandList LowLevelILInstructionBase::GetOperands() const
 {
-	auto usage = operationOperandUsage.find(operation);
-	if (usage == operationOperandUsage.end())
+	const LowLevelILOperationOperands* operands = GetOperationOperands(operation);
+	if (!operands)
 		throw LowLevelILInstructionAccessException();
-	auto operandIndex = operationOperandIndex.find(operation);
-	if (operandIndex == operationOperandIndex.end())
-		throw LowLevelILInstructionAccessException();
-	return LowLevelILOperandList(*(const LowLevelILInstruction*)this, usage->second, operandIndex->second);
+	return LowLevelILOperandList(*(const LowLevelILInstruction*)this, *operands);
 }
 
 
@@ -2016,6 +2059,55 @@ void LowLevelILInstruction::VisitExprs(const std::function<bool(const LowLevelIL
 }
 
 
+#ifndef BINARYNINJACORE_LIBRARY
+static void AppendLowLevelILExprForWalk(LowLevelILFunction* func, size_t expr, vector<LowLevelILExprVisitEntry>& stack)
+{
+	stack.push_back({func->GetRawExpr(expr), expr, false});
+}
+
+
+void LowLevelILInstruction::AppendOperandExprsForWalk(
+    LowLevelILFunction* func, const BNLowLevelILInstruction& instr, vector<LowLevelILExprVisitEntry>& stack)
+{
+	const LowLevelILOperationOperands* operands = GetOperationOperands(instr.operation);
+	if (!operands)
+		return;
+
+	for (size_t i = 0; i < operands->count; i++)
+	{
+		LowLevelILOperandType type;
+		if (!GetOperandTypeForUsage(operands->usages[i], type))
+			continue;
+
+		size_t operand = operands->operandIndex[i];
+		if (type == ExprLowLevelOperand)
+		{
+			AppendLowLevelILExprForWalk(func, (size_t)instr.operands[operand], stack);
+		}
+		else if (type == ExprListLowLevelOperand)
+		{
+			// Expression lists live in a separate parameter expression holding the count and the first list node.
+			// Each list node holds three entries followed by the index of the next node.
+			BNLowLevelILInstruction params = func->GetRawExpr((size_t)instr.operands[operand]);
+			size_t count = (size_t)params.operands[0];
+			if (count == 0)
+				continue;
+			BNLowLevelILInstruction node = func->GetRawExpr((size_t)params.operands[1]);
+			for (size_t j = 0, k = 0; j < count; j++, k++)
+			{
+				if (k == 3)
+				{
+					node = func->GetRawExpr((size_t)node.operands[3]);
+					k = 0;
+				}
+				AppendLowLevelILExprForWalk(func, (size_t)node.operands[k], stack);
+			}
+		}
+	}
+}
+#endif
+
+
 ExprId LowLevelILInstruction::CopyTo(LowLevelILFunction* dest) const
 {
 	return CopyTo(dest, [&](const LowLevelILInstruction& subExpr) { return subExpr.CopyTo(dest); });
@@ -2312,14 +2404,10 @@ ExprId LowLevelILInstruction::CopyTo(
 
 bool LowLevelILInstruction::GetOperandIndexForUsage(LowLevelILOperandUsage usage, size_t& operandIndex) const
 {
-	auto operationIter = LowLevelILInstructionBase::operationOperandIndex.find(operation);
-	if (operationIter == LowLevelILInstructionBase::operationOperandIndex.end())
-		return false;
-	auto usageIter = operationIter->second.find(usage);
-	if (usageIter == operationIter->second.end())
+	const LowLevelILOperationOperands* operands = GetOperationOperands(operation);
+	if (!operands)
 		return false;
-	operandIndex = usageIter->second;
-	return true;
+	return operands->GetOperandIndexForUsage(usage, operandIndex);
 }
 
 
@@ -361,6 +361,10 @@ namespace BinaryNinja
 		LowLevelILInstructionAccessException() : ExceptionWithStackTrace("invalid access to LLIL instruction") {}
 	};
 
+#ifndef BINARYNINJACORE_LIBRARY
+	typedef ILExprVisitEntry<BNLowLevelILInstruction> LowLevelILExprVisitEntry;
+#endif
+
 	/*!
 		\ingroup lowlevelil
 	*/
@@ -680,6 +684,34 @@ namespace BinaryNinja
 		operator _STD_VECTOR<SSARegisterOrFlag>() const;
 	};
 
+	/*! Operand layout of a single LLIL operation: the operand usages in order and the raw operand slot that
+		each of them starts at.
+
+		\ingroup lowlevelil
+	*/
+	struct LowLevelILOperationOperands
+	{
+		static constexpr size_t MaxOperandUsages = 6;
+
+		bool valid;
+		uint8_t count;
+		LowLevelILOperandUsage usages[MaxOperandUsages];
+		uint8_t operandIndex[MaxOperandUsages];
+
+		bool GetOperandIndexForUsage(LowLevelILOperandUsage usage, size_t& operand) const
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				if (usages[i] == usage)
+				{
+					operand = operandIndex[i];
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
 	/*!
 		\ingroup lowlevelil
 	*/
@@ -692,10 +724,8 @@ namespace BinaryNinja
 #endif
 		size_t exprIndex, instructionIndex;
 
-		static _STD_UNORDERED_MAP<LowLevelILOperandUsage, LowLevelILOperandType> operandTypeForUsage;
-		static _STD_UNORDERED_MAP<BNLowLevelILOperation, _STD_VECTOR<LowLevelILOperandUsage>> operationOperandUsage;
-		static _STD_UNORDERED_MAP<BNLowLevelILOperation, _STD_UNORDERED_MAP<LowLevelILOperandUsage, size_t>>
-		    operationOperandIndex;
+		static bool GetOperandTypeForUsage(LowLevelILOperandUsage usage, LowLevelILOperandType& type);
+		static const LowLevelILOperationOperands* GetOperationOperands(BNLowLevelILOperation operation);
 
 		LowLevelILOperandList GetOperands() const;
 
@@ -814,6 +844,40 @@ namespace BinaryNinja
 
 		void VisitExprs(const std::function<bool(const LowLevelILInstruction& expr)>& func) const;
 
+#ifndef BINARYNINJACORE_LIBRARY
+		/*! Walk this expression and its sub-expressions with an explicit stack instead of recursion.
+
+			The callback receives the index and raw instruction of each expression, no LowLevelILInstruction objects are
+			constructed during the walk. Operands are visited in operand order.
+
+			\param func Callable taking <tt>(size_t exprIndex, const BNLowLevelILInstruction& instr)</tt> and returning
+				an ILVisitAction, a bool (false skips the operands of the expression) or nothing
+			\param stack Scratch stack, pass the same vector to repeated walks to reuse its storage
+			\param order Whether expressions are visited before or after their operands
+			\return false if the walk was stopped by the callback
+		*/
+		template <typename F>
+		bool WalkExprs(
+		    F&& func, std::vector<LowLevelILExprVisitEntry>& stack, ILVisitOrder order = PreOrderILVisit) const
+		{
+			LowLevelILFunction* il = function;
+			return WalkILExprs<BNLowLevelILInstruction>(*this, exprIndex, func, stack, order,
+			    [il](const BNLowLevelILInstruction& instr, std::vector<LowLevelILExprVisitEntry>& children) {
+				    AppendOperandExprsForWalk(il, instr, children);
+			    });
+		}
+
+		template <typename F>
+		bool WalkExprs(F&& func, ILVisitOrder order = PreOrderILVisit) const
+		{
+			std::vector<LowLevelILExprVisitEntry> stack;
+			return WalkExprs(func, stack, order);
+		}
+
+		static void AppendOperandExprsForWalk(LowLevelILFunction* func, const BNLowLevelILInstruction& instr,
+		    std::vector<LowLevelILExprVisitEntry>& stack);
+#endif
+
 		ExprId CopyTo(LowLevelILFunction* dest) const;
 		ExprId CopyTo(LowLevelILFunction* dest,
 		    const std::function<ExprId(const LowLevelILInstruction& subExpr)>& subExprHandler) const;
@@ -1219,7 +1283,7 @@ namespace BinaryNinja
 		struct ListIterator
 		{
 			const LowLevelILOperandList* owner;
-			_STD_VECTOR<LowLevelILOperandUsage>::const_iterator pos;
+			size_t pos;
 			bool operator==(const ListIterator& a) const { return pos == a.pos; }
 			bool operator!=(const ListIterator& a) const { return pos != a.pos; }
 			bool operator<(const ListIterator& a) const { return pos < a.pos; }
@@ -1232,14 +1296,12 @@ namespace BinaryNinja
 		};
 
 		LowLevelILInstruction m_instr;
-		const _STD_VECTOR<LowLevelILOperandUsage>& m_usageList;
-		const _STD_UNORDERED_MAP<LowLevelILOperandUsage, size_t>& m_operandIndexMap;
+		const LowLevelILOperationOperands& m_operands;
 
 	  public:
 		typedef ListIterator const_iterator;
 
-		LowLevelILOperandList(const LowLevelILInstruction& instr, const _STD_VECTOR<LowLevelILOperandUsage>& usageList,
-		    const _STD_UNORDERED_MAP<LowLevelILOperandUsage, size_t>& operandIndexMap);
+		LowLevelILOperandList(const LowLevelILInstruction& instr, const LowLevelILOperationOperands& operands);
 
 		const_iterator begin() const;
 		const_iterator end() const;
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <list>
 #include "binaryninjaapi.h"
 
 using namespace BinaryNinja;
@@ -118,3 +120,136 @@ bool BinaryNinja::IsMainThread()
 {
 	return BNIsMainThread();
 }
+
+
+namespace
+{
+	struct CoalescedMainThreadAction
+	{
+		string key;
+		function<void()> action;
+		chrono::steady_clock::time_point posted;
+	};
+
+	struct CoalescedMainThreadQueue
+	{
+		mutex lock;
+		list<CoalescedMainThreadAction> actions;
+		unordered_map<string, list<CoalescedMainThreadAction>::iterator> keys;
+		bool drainScheduled = false;
+		uint64_t budgetUs = 8000;
+		MainThreadQueueStats stats {};
+	};
+}  // namespace
+
+
+static CoalescedMainThreadQueue& GetCoalescedMainThreadQueue()
+{
+	static CoalescedMainThreadQueue* queue = new CoalescedMainThreadQueue;
+	return *queue;
+}
+
+
+static void DrainCoalescedMainThreadQueue()
+{
+	CoalescedMainThreadQueue& queue = GetCoalescedMainThreadQueue();
+	auto start = chrono::steady_clock::now();
+	uint64_t budgetUs;
+	{
+		lock_guard<mutex> guard(queue.lock);
+		queue.stats.drains++;
+		budgetUs = queue.budgetUs;
+	}
+
+	for (size_t ran = 0;; ran++)
+	{
+		CoalescedMainThreadAction next;
+		{
+			lock_guard<mutex> guard(queue.lock);
+			if (queue.actions.empty())
+			{
+				queue.drainScheduled = false;
+				return;
+			}
+
+			auto now = chrono::steady_clock::now();
+			uint64_t elapsed = (uint64_t)chrono::duration_cast<chrono::microseconds>(now - start).count();
+			if ((ran != 0) && (elapsed >= budgetUs))
+			{
+				// Out of time for this pass, leave the rest for the next one
+				break;
+			}
+
+			next = std::move(queue.actions.front());
+			queue.actions.pop_front();
+			if (!next.key.empty())
+				queue.keys.erase(next.key);
+
+			uint64_t latency = (uint64_t)chrono::duration_cast<chrono::microseconds>(now - next.posted).count();
+			queue.stats.pending = queue.actions.size();
+			queue.stats.executed++;
+			queue.stats.totalLatencyUs += latency;
+			queue.stats.maxLatencyUs = max(queue.stats.maxLatencyUs, latency);
+		}
+
+		try
+		{
+			next.action();
+		}
+		catch (const std::exception& e)
+		{
+			LogError("Exception in main thread handler: %s", e.what());
+		}
+		catch (...)
+		{
+			LogError("Exception in main thread handler: <unknown exception>");
+		}
+	}
+
+	ExecuteOnMainThread(DrainCoalescedMainThreadQueue);
+}
+
+
+void BinaryNinja::ExecuteOnMainThreadCoalesced(const string& key, const function<void()>& action)
+{
+	CoalescedMainThreadQueue& queue = GetCoalescedMainThreadQueue();
+	{
+		lock_guard<mutex> guard(queue.lock);
+		queue.stats.posted++;
+		auto existing = key.empty() ? queue.keys.end() : queue.keys.find(key);
+		if (existing != queue.keys.end())
+		{
+			// Keep the original position and post time so that latency covers the whole wait
+			existing->second->action = action;
+			queue.stats.coalesced++;
+			return;
+		}
+
+		queue.actions.push_back({key, action, chrono::steady_clock::now()});
+		if (!key.empty())
+			queue.keys[key] = prev(queue.actions.end());
+		queue.stats.pending = queue.actions.size();
+		if (queue.drainScheduled)
+			return;
+		queue.drainScheduled = true;
+	}
+
+	ExecuteOnMainThread(DrainCoalescedMainThreadQueue);
+}
+
+
+void BinaryNinja::SetMainThreadQueueBudget(uint64_t microseconds)
+{
+	CoalescedMainThreadQueue& queue = GetCoalescedMainThreadQueue();
+	lock_guard<mutex> guard(queue.lock);
+	queue.budgetUs = microseconds;
+}
+
+
+MainThreadQueueStats BinaryNinja::GetMainThreadQueueStats()
+{
+	CoalescedMainThreadQueue& queue = GetCoalescedMainThreadQueue();
+	lock_guard<mutex> guard(queue.lock);
+	return queue.stats;
+}
+
@@ -36,7 +36,41 @@ using namespace std;
 #endif
 
 
-unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType> MediumLevelILInstructionBase::operandTypeForUsage = {
+static constexpr size_t MediumLevelILOperationCount = (size_t)MLIL_MEM_PHI + 1;
+static constexpr size_t MediumLevelILOperandUsageCount = (size_t)SourceSSAVariablesMediumLevelOperandUsages + 1;
+
+
+struct MediumLevelILOperandTypeEntry
+{
+	MediumLevelILOperandUsage usage;
+	MediumLevelILOperandType type;
+};
+
+
+struct MediumLevelILOperationUsageEntry
+{
+	BNMediumLevelILOperation operation;
+	size_t count = 0;
+	MediumLevelILOperandUsage usages[MediumLevelILOperationOperands::MaxOperandUsages] = {};
+
+	constexpr MediumLevelILOperationUsageEntry(
+	    BNMediumLevelILOperation op, std::initializer_list<MediumLevelILOperandUsage> list) :
+	    operation(op)
+	{
+		for (auto usage : list)
+			usages[count++] = usage;
+	}
+};
+
+
+struct MediumLevelILOperandTables
+{
+	MediumLevelILOperandType operandTypeForUsage[MediumLevelILOperandUsageCount];
+	MediumLevelILOperationOperands operationOperands[MediumLevelILOperationCount];
+};
+
+
+static constexpr MediumLevelILOperandTypeEntry s_operandTypeForUsage[] = {
     {SourceExprMediumLevelOperandUsage, ExprMediumLevelOperand},
     {SourceVariableMediumLevelOperandUsage, VariableMediumLevelOperand},
     {SourceSSAVariableMediumLevelOperandUsage, SSAVariableMediumLevelOperand},
@@ -78,8 +112,8 @@ unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType> MediumLevelIL
     {SourceSSAVariablesMediumLevelOperandUsages, SSAVariableListMediumLevelOperand}};
 
 
-unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>>
-    MediumLevelILInstructionBase::operationOperandUsage = {{MLIL_NOP, {}}, {MLIL_NORET, {}}, {MLIL_BP, {}},
+static constexpr MediumLevelILOperationUsageEntry s_operationOperandUsage[] =
+    {{MLIL_NOP, {}}, {MLIL_NORET, {}}, {MLIL_BP, {}},
         {MLIL_UNDEF, {}}, {MLIL_UNIMPL, {}},
         {MLIL_SET_VAR, {DestVariableMediumLevelOperandUsage, SourceExprMediumLevelOperandUsage}},
         {MLIL_SET_VAR_FIELD,
@@ -239,19 +273,24 @@ unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>>
         {MLIL_FCMP_UO, {LeftExprMediumLevelOperandUsage, RightExprMediumLevelOperandUsage}}};
 
 
-static unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperandUsage, size_t>>
-    GetOperandIndexForOperandUsages()
+static constexpr MediumLevelILOperandTables GetOperandTables()
 {
-	unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperandUsage, size_t>> result;
-	result.reserve(MediumLevelILInstructionBase::operationOperandUsage.size());
-	for (auto& operation : MediumLevelILInstructionBase::operationOperandUsage)
+	MediumLevelILOperandTables result = {};
+	for (auto& entry : s_operandTypeForUsage)
+		result.operandTypeForUsage[entry.usage] = entry.type;
+
+	for (auto& operation : s_operationOperandUsage)
 	{
-		result[operation.first] = unordered_map<MediumLevelILOperandUsage, size_t>();
-		result[operation.first].reserve(operation.second.size());
+		MediumLevelILOperationOperands& operands = result.operationOperands[operation.operation];
+		operands.valid = true;
+		operands.count = (uint8_t)operation.count;
+
 		size_t operand = 0;
-		for (auto usage : operation.second)
+		for (size_t i = 0; i < operation.count; i++)
 		{
-			result[operation.first][usage] = operand;
+			MediumLevelILOperandUsage usage = operation.usages[i];
+			operands.usages[i] = usage;
+			operands.operandIndex[i] = (uint8_t)operand;
 			switch (usage)
 			{
 			case PartialSSAVariableSourceMediumLevelOperandUsage:
@@ -271,7 +310,7 @@ static unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperan
 				// ParameterSSAMemoryVersionMediumLevelOperandUsage follows at same operand
 				break;
 			default:
-				switch (MediumLevelILInstructionBase::operandTypeForUsage[usage])
+				switch (result.operandTypeForUsage[usage])
 				{
 				case SSAVariableMediumLevelOperand:
 				case IndexListMediumLevelOperand:
@@ -294,8 +333,27 @@ static unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperan
 }
 
 
-unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperandUsage, size_t>>
-    MediumLevelILInstructionBase::operationOperandIndex = GetOperandIndexForOperandUsages();
+static constexpr MediumLevelILOperandTables s_operandTables = GetOperandTables();
+
+
+bool MediumLevelILInstructionBase::GetOperandTypeForUsage(
+    MediumLevelILOperandUsage usage, MediumLevelILOperandType& type)
+{
+	if ((size_t)usage >= MediumLevelILOperandUsageCount)
+		return false;
+	type = s_operandTables.operandTypeForUsage[usage];
+	return true;
+}
+
+
+const MediumLevelILOperationOperands* MediumLevelILInstructionBase::GetOperationOperands(
+    BNMediumLevelILOperation operation)
+{
+	if ((size_t)operation >= MediumLevelILOperationCount)
+		return nullptr;
+	const MediumLevelILOperationOperands& operands = s_operandTables.operationOperands[operation];
+	return operands.valid ? &operands : nullptr;
+}
 
 
 SSAVariable::SSAVariable() : version(0) {}
@@ -718,10 +776,8 @@ MediumLevelILOperand::MediumLevelILOperand(
     m_instr(instr),
     m_usage(usage), m_operandIndex(operandIndex)
 {
-	auto i = MediumLevelILInstructionBase::operandTypeForUsage.find(m_usage);
-	if (i == MediumLevelILInstructionBase::operandTypeForUsage.end())
+	if (!MediumLevelILInstructionBase::GetOperandTypeForUsage(m_usage, m_type))
 		throw MediumLevelILInstructionAccessException();
-	m_type = i->second;
 }
 
 
@@ -834,19 +890,13 @@ MediumLevelILInstructionList MediumLevelILOperand::GetExprList() const
 
 const MediumLevelILOperand MediumLevelILOperandList::ListIterator::operator*()
 {
-	MediumLevelILOperandUsage usage = *pos;
-	auto i = owner->m_operandIndexMap.find(usage);
-	if (i == owner->m_operandIndexMap.end())
-		throw MediumLevelILInstructionAccessException();
-	return MediumLevelILOperand(owner->m_instr, usage, i->second);
+	return MediumLevelILOperand(owner->m_instr, owner->m_operands.usages[pos], owner->m_operands.operandIndex[pos]);
 }
 
 
-MediumLevelILOperandList::MediumLevelILOperandList(const MediumLevelILInstruction& instr,
-    const vector<MediumLevelILOperandUsage>& usageList,
-    const unordered_map<MediumLevelILOperandUsage, size_t>& operandIndexMap) :
-    m_instr(instr),
-    m_usageList(usageList), m_operandIndexMap(operandIndexMap)
+MediumLevelILOperandList::MediumLevelILOperandList(
+    const MediumLevelILInstruction& instr, const MediumLevelILOperationOperands& operands) :
+    m_instr(instr), m_operands(operands)
 {}
 
 
@@ -854,7 +904,7 @@ MediumLevelILOperandList::const_iterator MediumLevelILOperandList::begin() const
 {
 	const_iterator result;
 	result.owner = this;
-	result.pos = m_usageList.begin();
+	result.pos = 0;
 	return result;
 }
 
@@ -863,24 +913,22 @@ MediumLevelILOperandList::const_iterator MediumLevelILOperandList::end() const
 {
 	const_iterator result;
 	result.owner = this;
-	result.pos = m_usageList.end();
+	result.pos = m_operands.count;
 	return result;
 }
 
 
 size_t MediumLevelILOperandList::size() const
 {
-	return m_usageList.size();
+	return m_operands.count;
 }
 
 
 const MediumLevelILOperand MediumLevelILOperandList::operator[](size_t i) const
 {
-	MediumLevelILOperandUsage usage = m_usageList[i];
-	auto indexMap = m_operandIndexMap.find(usage);
-	if (indexMap == m_operandIndexMap.end())
+	if (i >= m_operands.count)
 		throw MediumLevelILInstructionAccessException();
-	return MediumLevelILOperand(m_instr, usage, indexMap->second);
+	return MediumLevelILOperand(m_instr, m_operands.usages[i], m_operands.operandIndex[i]);
 }
 
 
@@ -945,13 +993,10 @@ MediumLevelILInstruction::MediumLevelILInstruction(const MediumLevelILInstructio
 
 MediumLevelILOperandList MediumLevelILInstructionBase::GetOperands() const
 {
-	auto usage = operationOperandUsage.find(operation);
-	if (usage == operationOperandUsage.end())
-		throw MediumLevelILInstructionAccessException();
-	auto operandIndex = operationOperandIndex.find(operation);
-	if (operandIndex == operationOperandIndex.end())
+	const MediumLevelILOperationOperands* operands = GetOperationOperands(operation);
+	if (!operands)
 		throw MediumLevelILInstructionAccessException();
-	return MediumLevelILOperandList(*(const MediumLevelILInstruction*)this, usage->second, operandIndex->second);
+	return MediumLevelILOperandList(*(const MediumLevelILInstruction*)this, *operands);
 }
 
 
@@ -1571,6 +1616,55 @@ void MediumLevelILInstruction::VisitExprs(const std::function<bool(const MediumL
 }
 
 
+#ifndef BINARYNINJACORE_LIBRARY
+static void AppendMediumLevelILExprForWalk(
+    MediumLevelILFunction* func, size_t expr, vector<MediumLevelILExprVisitEntry>& stack)
+{
+	stack.push_back({func->GetRawExpr(expr), expr, false});
+}
+
+
+void MediumLevelILInstruction::AppendOperandExprsForWalk(
+    MediumLevelILFunction* func, const BNMediumLevelILInstruction& instr, vector<MediumLevelILExprVisitEntry>& stack)
+{
+	const MediumLevelILOperationOperands* operands = GetOperationOperands(instr.operation);
+	if (!operands)
+		return;
+
+	for (size_t i = 0; i < operands->count; i++)
+	{
+		MediumLevelILOperandType type;
+		if (!GetOperandTypeForUsage(operands->usages[i], type))
+			continue;
+
+		size_t operand = operands->operandIndex[i];
+		if (type == ExprMediumLevelOperand)
+		{
+			AppendMediumLevelILExprForWalk(func, (size_t)instr.operands[operand], stack);
+		}
+		else if (type == ExprListMediumLevelOperand)
+		{
+			// Lists are a count followed by the first list node. Each list node holds four entries followed by the
+			// index of the next node.
+			size_t count = (size_t)instr.operands[operand];
+			if (count == 0)
+				continue;
+			BNMediumLevelILInstruction node = func->GetRawExpr((size_t)instr.operands[operand + 1]);
+			for (size_t j = 0, k = 0; j < count; j++, k++)
+			{
+				if (k == 4)
+				{
+					node = func->GetRawExpr((size_t)node.operands[4]);
+					k = 0;
+				}
+				AppendMediumLevelILExprForWalk(func, (size_t)node.operands[k], stack);
+			}
+		}
+	}
+}
+#endif
+
+
 ExprId MediumLevelILInstruction::CopyTo(MediumLevelILFunction* dest) const
 {
 	return CopyTo(dest, [&](const MediumLevelILInstruction& subExpr) { return subExpr.CopyTo(dest); });
@@ -1874,14 +1968,10 @@ ExprId MediumLevelILInstruction::CopyTo(MediumLevelILFunction* dest,
 
 bool MediumLevelILInstruction::GetOperandIndexForUsage(MediumLevelILOperandUsage usage, size_t& operandIndex) const
 {
-	auto operationIter = MediumLevelILInstructionBase::operationOperandIndex.find(operation);
-	if (operationIter == MediumLevelILInstructionBase::operationOperandIndex.end())
-		return false;
-	auto usageIter = operationIter->second.find(usage);
-	if (usageIter == operationIter->second.end())
+	const MediumLevelILOperationOperands* operands = GetOperationOperands(operation);
+	if (!operands)
 		return false;
-	operandIndex = usageIter->second;
-	return true;
+	return operands->GetOperandIndexForUsage(usage, operandIndex);
 }
 
 
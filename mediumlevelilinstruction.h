@@ -211,6 +211,10 @@ namespace BinaryNinja
 		MediumLevelILInstructionAccessException() : ExceptionWithStackTrace("invalid access to MLIL instruction") {}
 	};
 
+#ifndef BINARYNINJACORE_LIBRARY
+	typedef ILExprVisitEntry<BNMediumLevelILInstruction> MediumLevelILExprVisitEntry;
+#endif
+
 	/*!
 		\ingroup mediumlevelil
 	*/
@@ -425,6 +429,34 @@ namespace BinaryNinja
 		operator _STD_VECTOR<MediumLevelILInstruction>() const;
 	};
 
+	/*! Operand layout of a single MLIL operation: the operand usages in order and the raw operand slot that
+		each of them starts at.
+
+		\ingroup mediumlevelil
+	*/
+	struct MediumLevelILOperationOperands
+	{
+		static constexpr size_t MaxOperandUsages = 6;
+
+		bool valid;
+		uint8_t count;
+		MediumLevelILOperandUsage usages[MaxOperandUsages];
+		uint8_t operandIndex[MaxOperandUsages];
+
+		bool GetOperandIndexForUsage(MediumLevelILOperandUsage usage, size_t& operand) const
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				if (usages[i] == usage)
+				{
+					operand = operandIndex[i];
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
 	/*!
 		\ingroup mediumlevelil
 	*/
@@ -437,11 +469,8 @@ namespace BinaryNinja
 #endif
 		size_t exprIndex, instructionIndex;
 
-		static _STD_UNORDERED_MAP<MediumLevelILOperandUsage, MediumLevelILOperandType> operandTypeForUsage;
-		static _STD_UNORDERED_MAP<BNMediumLevelILOperation, _STD_VECTOR<MediumLevelILOperandUsage>>
-		    operationOperandUsage;
-		static _STD_UNORDERED_MAP<BNMediumLevelILOperation, _STD_UNORDERED_MAP<MediumLevelILOperandUsage, size_t>>
-		    operationOperandIndex;
+		static bool GetOperandTypeForUsage(MediumLevelILOperandUsage usage, MediumLevelILOperandType& type);
+		static const MediumLevelILOperationOperands* GetOperationOperands(BNMediumLevelILOperation operation);
 
 		MediumLevelILOperandList GetOperands() const;
 
@@ -572,6 +601,40 @@ namespace BinaryNinja
 
 		void VisitExprs(const std::function<bool(const MediumLevelILInstruction& expr)>& func) const;
 
+#ifndef BINARYNINJACORE_LIBRARY
+		/*! Walk this expression and its sub-expressions with an explicit stack instead of recursion.
+
+			The callback receives the index and raw instruction of each expression, no MediumLevelILInstruction objects are
+			constructed during the walk. Operands are visited in operand order.
+
+			\param func Callable taking <tt>(size_t exprIndex, const BNMediumLevelILInstruction& instr)</tt> and returning
+				an ILVisitAction, a bool (false skips the operands of the expression) or nothing
+			\param stack Scratch stack, pass the same vector to repeated walks to reuse its storage
+			\param order Whether expressions are visited before or after their operands
+			\return false if the walk was stopped by the callback
+		*/
+		template <typename F>
+		bool WalkExprs(
+		    F&& func, std::vector<MediumLevelILExprVisitEntry>& stack, ILVisitOrder order = PreOrderILVisit) const
+		{
+			MediumLevelILFunction* il = function;
+			return WalkILExprs<BNMediumLevelILInstruction>(*this, exprIndex, func, stack, order,
+			    [il](const BNMediumLevelILInstruction& instr, std::vector<MediumLevelILExprVisitEntry>& children) {
+				    AppendOperandExprsForWalk(il, instr, children);
+			    });
+		}
+
+		template <typename F>
+		bool WalkExprs(F&& func, ILVisitOrder order = PreOrderILVisit) const
+		{
+			std::vector<MediumLevelILExprVisitEntry> stack;
+			return WalkExprs(func, stack, order);
+		}
+
+		static void AppendOperandExprsForWalk(MediumLevelILFunction* func, const BNMediumLevelILInstruction& instr,
+		    std::vector<MediumLevelILExprVisitEntry>& stack);
+#endif
+
 		ExprId CopyTo(MediumLevelILFunction* dest) const;
 		ExprId CopyTo(MediumLevelILFunction* dest,
 		    const std::function<ExprId(const MediumLevelILInstruction& subExpr)>& subExprHandler) const;
@@ -888,7 +951,7 @@ namespace BinaryNinja
 		struct ListIterator
 		{
 			const MediumLevelILOperandList* owner;
-			_STD_VECTOR<MediumLevelILOperandUsage>::const_iterator pos;
+			size_t pos;
 			bool operator==(const ListIterator& a) const { return pos == a.pos; }
 			bool operator!=(const ListIterator& a) const { return pos != a.pos; }
 			bool operator<(const ListIterator& a) const { return pos < a.pos; }
@@ -901,15 +964,12 @@ namespace BinaryNinja
 		};
 
 		MediumLevelILInstruction m_instr;
-		const _STD_VECTOR<MediumLevelILOperandUsage>& m_usageList;
-		const _STD_UNORDERED_MAP<MediumLevelILOperandUsage, size_t>& m_operandIndexMap;
+		const MediumLevelILOperationOperands& m_operands;
 
 	  public:
 		typedef ListIterator const_iterator;
 
-		MediumLevelILOperandList(const MediumLevelILInstruction& instr,
-		    const _STD_VECTOR<MediumLevelILOperandUsage>& usageList,
-		    const _STD_UNORDERED_MAP<MediumLevelILOperandUsage, size_t>& operandIndexMap);
+		MediumLevelILOperandList(const MediumLevelILInstruction& instr, const MediumLevelILOperationOperands& operands);
 
 		const_iterator begin() const;
 		const_iterator end() const;
@@ -1,6 +1,11 @@
 #include "binaryninjaapi.h"
 #include "json/json.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 using namespace BinaryNinja;
@@ -100,6 +105,263 @@ bool AnalysisContext::Inform(const string& request)
 }
 
 
+struct AnalysisDataEntry
+{
+	size_t slot;
+	bool invalidateOnReanalysis;
+	shared_ptr<void> value;
+};
+
+struct AnalysisDataShard
+{
+	mutex entryMutex;
+	unordered_map<void*, vector<AnalysisDataEntry>> owners;
+};
+
+static constexpr size_t AnalysisDataShardCount = 16;
+static atomic<size_t> g_nextAnalysisDataSlot {1};
+static once_flag g_analysisDataCallbacksRegistered;
+static BNObjectDestructionCallbacks g_analysisDataDestructionCallbacks;
+static BNBinaryDataNotification g_analysisDataNotification;
+
+
+static AnalysisDataShard* GetAnalysisDataShards()
+{
+	// Never freed so that static slots in plugins can still be released during process exit
+	static AnalysisDataShard* shards = new AnalysisDataShard[AnalysisDataShardCount];
+	return shards;
+}
+
+
+static AnalysisDataShard& GetAnalysisDataShard(void* owner)
+{
+	uintptr_t key = reinterpret_cast<uintptr_t>(owner);
+	return GetAnalysisDataShards()[((key >> 4) ^ (key >> 12)) % AnalysisDataShardCount];
+}
+
+
+static mutex& GetAnalysisDataViewMutex()
+{
+	static mutex* viewMutex = new mutex;
+	return *viewMutex;
+}
+
+
+static unordered_set<BNBinaryView*>& GetAnalysisDataViews()
+{
+	// Views that have the reanalysis notification registered
+	static unordered_set<BNBinaryView*>* views = new unordered_set<BNBinaryView*>;
+	return *views;
+}
+
+
+static void ReleaseAnalysisData(void* owner, bool reanalysisOnly)
+{
+	vector<AnalysisDataEntry> released;
+	AnalysisDataShard& shard = GetAnalysisDataShard(owner);
+	{
+		unique_lock<mutex> lock(shard.entryMutex);
+		auto i = shard.owners.find(owner);
+		if (i == shard.owners.end())
+			return;
+		if (!reanalysisOnly)
+		{
+			released = std::move(i->second);
+			shard.owners.erase(i);
+		}
+		else
+		{
+			auto& entries = i->second;
+			for (auto& entry : entries)
+				if (entry.invalidateOnReanalysis)
+					released.push_back(std::move(entry));
+			entries.erase(remove_if(entries.begin(), entries.end(),
+				[](const AnalysisDataEntry& entry) { return entry.invalidateOnReanalysis; }), entries.end());
+			if (entries.empty())
+				shard.owners.erase(i);
+		}
+	}
+	// Values are destroyed here, outside of the shard lock, as their destructors may use the datastore
+}
+
+
+static void AnalysisDataViewDestroyed(void*, BNBinaryView* view)
+{
+	ReleaseAnalysisData(view, false);
+	lock_guard<mutex> lock(GetAnalysisDataViewMutex());
+	GetAnalysisDataViews().erase(view);
+}
+
+
+static void AnalysisDataFunctionDestroyed(void*, BNFunction* func)
+{
+	ReleaseAnalysisData(func, false);
+}
+
+
+static void AnalysisDataFunctionUpdateRequested(void*, BNBinaryView*, BNFunction* func)
+{
+	ReleaseAnalysisData(func, true);
+}
+
+
+static void RegisterAnalysisDataCallbacks()
+{
+	call_once(g_analysisDataCallbacksRegistered, []() {
+		g_analysisDataDestructionCallbacks.context = nullptr;
+		g_analysisDataDestructionCallbacks.destructBinaryView = AnalysisDataViewDestroyed;
+		g_analysisDataDestructionCallbacks.destructFunction = AnalysisDataFunctionDestroyed;
+		BNRegisterObjectDestructionCallbacks(&g_analysisDataDestructionCallbacks);
+		g_analysisDataNotification.functionUpdateRequested = AnalysisDataFunctionUpdateRequested;
+	});
+}
+
+
+static void RegisterAnalysisDataReanalysisNotification(BNFunction* func)
+{
+	BNBinaryView* view = BNGetFunctionData(func);
+	if (!view)
+		return;
+	{
+		lock_guard<mutex> lock(GetAnalysisDataViewMutex());
+		// The registration is dropped along with the view, there is nothing to unregister
+		if (GetAnalysisDataViews().insert(view).second)
+			BNRegisterDataNotification(view, &g_analysisDataNotification);
+	}
+	BNFreeBinaryView(view);
+}
+
+
+AnalysisDataSlotBase::AnalysisDataSlotBase(bool invalidateOnReanalysis) :
+    m_id(g_nextAnalysisDataSlot.fetch_add(1)), m_invalidateOnReanalysis(invalidateOnReanalysis)
+{
+}
+
+
+AnalysisDataSlotBase::~AnalysisDataSlotBase()
+{
+	Clear();
+}
+
+
+shared_ptr<void> AnalysisDataSlotBase::GetEntry(void* owner) const
+{
+	AnalysisDataShard& shard = GetAnalysisDataShard(owner);
+	lock_guard<mutex> lock(shard.entryMutex);
+	auto i = shard.owners.find(owner);
+	if (i == shard.owners.end())
+		return nullptr;
+	for (auto& entry : i->second)
+		if (entry.slot == m_id)
+			return entry.value;
+	return nullptr;
+}
+
+
+shared_ptr<void> AnalysisDataSlotBase::GetOrCreateEntry(
+    BNBinaryView* view, BNFunction* func, const function<shared_ptr<void>()>& create)
+{
+	void* owner = view ? (void*)view : (void*)func;
+	if (shared_ptr<void> existing = GetEntry(owner))
+		return existing;
+
+	// Create outside of the shard lock, a racing creator may win and this value is then discarded
+	shared_ptr<void> value = create();
+	RegisterAnalysisDataCallbacks();
+	if (func && m_invalidateOnReanalysis)
+		RegisterAnalysisDataReanalysisNotification(func);
+
+	AnalysisDataShard& shard = GetAnalysisDataShard(owner);
+	lock_guard<mutex> lock(shard.entryMutex);
+	auto& entries = shard.owners[owner];
+	for (auto& entry : entries)
+		if (entry.slot == m_id)
+			return entry.value;
+	entries.push_back({m_id, func && m_invalidateOnReanalysis, value});
+	return value;
+}
+
+
+void AnalysisDataSlotBase::SetEntry(BNBinaryView* view, BNFunction* func, shared_ptr<void> value)
+{
+	void* owner = view ? (void*)view : (void*)func;
+	if (!value)
+	{
+		RemoveEntry(owner);
+		return;
+	}
+
+	RegisterAnalysisDataCallbacks();
+	if (func && m_invalidateOnReanalysis)
+		RegisterAnalysisDataReanalysisNotification(func);
+
+	AnalysisDataShard& shard = GetAnalysisDataShard(owner);
+	unique_lock<mutex> lock(shard.entryMutex);
+	auto& entries = shard.owners[owner];
+	for (auto& entry : entries)
+	{
+		if (entry.slot == m_id)
+		{
+			swap(entry.value, value);
+			lock.unlock();
+			return;  // Previous value is released outside of the lock
+		}
+	}
+	entries.push_back({m_id, func && m_invalidateOnReanalysis, std::move(value)});
+}
+
+
+void AnalysisDataSlotBase::RemoveEntry(void* owner)
+{
+	shared_ptr<void> released;
+	AnalysisDataShard& shard = GetAnalysisDataShard(owner);
+	lock_guard<mutex> lock(shard.entryMutex);
+	auto i = shard.owners.find(owner);
+	if (i == shard.owners.end())
+		return;
+	auto& entries = i->second;
+	for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+	{
+		if (entry->slot == m_id)
+		{
+			released = std::move(entry->value);
+			entries.erase(entry);
+			break;
+		}
+	}
+	if (entries.empty())
+		shard.owners.erase(i);
+}
+
+
+void AnalysisDataSlotBase::Clear()
+{
+	AnalysisDataShard* shards = GetAnalysisDataShards();
+	for (size_t i = 0; i < AnalysisDataShardCount; i++)
+	{
+		vector<shared_ptr<void>> released;
+		lock_guard<mutex> lock(shards[i].entryMutex);
+		for (auto owner = shards[i].owners.begin(); owner != shards[i].owners.end();)
+		{
+			auto& entries = owner->second;
+			for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+			{
+				if (entry->slot == m_id)
+				{
+					released.push_back(std::move(entry->value));
+					entries.erase(entry);
+					break;
+				}
+			}
+			if (entries.empty())
+				owner = shards[i].owners.erase(owner);
+			else
+				++owner;
+		}
+	}
+}
+
+
 Workflow::Workflow(const string& name)
 {
 	m_object = BNCreateWorkflow(name.c_str());